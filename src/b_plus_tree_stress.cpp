@@ -0,0 +1,195 @@
+#include <sys/stat.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "common/instance.h"
+#include "glog/logging.h"
+#include "index/b_plus_tree.h"
+#include "index/generic_key.h"
+#include "record/row.h"
+#include "record/schema.h"
+
+/**
+ * Stress test and scaling benchmark of the latch crabbing B+ tree.
+ *
+ * Usage: b_plus_tree_stress [threads] [keys per thread] [buffer pool size]
+ * Without a thread count the run is repeated with 1, 2, 4, 8, 16 and 32 threads.
+ *
+ * Each run inserts the keys of all threads interleaved, so neighbouring keys come from different threads, and every
+ * thread looks up each key right after inserting it and tries to insert it again. Then every thread removes its odd
+ * keys while looking up its even ones, next to a thread scanning the whole tree. A small buffer pool forces pages of
+ * the tree to be evicted and read back while they are latched by others.
+ */
+
+static const char *kDbName = "b_plus_tree_stress.db";
+static const int kKeySize = 16;
+
+struct StressContext {
+  BPlusTree *tree;
+  const KeyManager *key_manager;
+  Schema *schema;
+  int threads;
+  int keys_per_thread;
+  std::atomic<int> errors{0};
+};
+
+/** Encode key k, its row id is (k, 0). */
+static GenericKey *MakeKey(const StressContext &ctx, int k) {
+  std::vector<Field> fields;
+  fields.emplace_back(TypeId::kTypeInt, k);
+  Row row(fields);
+  GenericKey *key = ctx.key_manager->InitKey();
+  ctx.key_manager->SerializeFromKey(key, row, ctx.schema);
+  return key;
+}
+
+static bool Lookup(StressContext &ctx, int k) {
+  GenericKey *key = MakeKey(ctx, k);
+  std::vector<RowId> result;
+  bool found = ctx.tree->GetValue(key, result);
+  free(key);
+  if (found && (result.size() != 1 || result[0].GetPageId() != k)) {
+    LOG(ERROR) << "Lookup of key " << k << " returned a wrong row.";
+    ctx.errors++;
+  }
+  return found;
+}
+
+static void InsertWorker(StressContext &ctx, int thread_id) {
+  for (int i = 0; i < ctx.keys_per_thread; i++) {
+    int k = i * ctx.threads + thread_id;
+    GenericKey *key = MakeKey(ctx, k);
+    if (!ctx.tree->Insert(key, RowId(k, 0))) {
+      LOG(ERROR) << "Insert of new key " << k << " failed.";
+      ctx.errors++;
+    }
+    if (ctx.tree->Insert(key, RowId(k, 0))) {
+      LOG(ERROR) << "Duplicate insert of key " << k << " succeeded.";
+      ctx.errors++;
+    }
+    free(key);
+    if (!Lookup(ctx, k)) {
+      LOG(ERROR) << "Inserted key " << k << " not found.";
+      ctx.errors++;
+    }
+  }
+}
+
+static void RemoveWorker(StressContext &ctx, int thread_id) {
+  for (int i = 0; i < ctx.keys_per_thread; i++) {
+    int k = i * ctx.threads + thread_id;
+    if (k % 2 == 1) {
+      GenericKey *key = MakeKey(ctx, k);
+      ctx.tree->Remove(key);
+      free(key);
+    } else if (!Lookup(ctx, k)) {
+      LOG(ERROR) << "Key " << k << " lost while other keys were removed.";
+      ctx.errors++;
+    }
+  }
+}
+
+/** Scan the tree while it is modified, the keys must come in ascending order. */
+static void ScanWorker(StressContext &ctx, std::atomic<bool> &done) {
+  while (!done) {
+    int last = -1;
+    for (auto it = ctx.tree->Begin(); it != ctx.tree->End(); ++it) {
+      int k = (*it).second.GetPageId();
+      if (k <= last) {
+        LOG(ERROR) << "Scan returned key " << k << " after key " << last << ".";
+        ctx.errors++;
+      }
+      last = k;
+    }
+  }
+}
+
+/** Run both phases with the given number of threads, @return false if any check failed */
+static bool RunStress(int threads, int keys_per_thread, uint32_t buffer_pool_size) {
+  DBStorageEngine engine(kDbName, true, buffer_pool_size, 1, false);
+  std::vector<Column *> columns = {new Column("k", TypeId::kTypeInt, 0, false, true)};
+  Schema schema(columns);
+  KeyManager key_manager(&schema, kKeySize);
+  BPlusTree tree(0, engine.bpm_, key_manager);
+  StressContext ctx;
+  ctx.tree = &tree;
+  ctx.key_manager = &key_manager;
+  ctx.schema = &schema;
+  ctx.threads = threads;
+  ctx.keys_per_thread = keys_per_thread;
+  int total = threads * keys_per_thread;
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> workers;
+  for (int i = 0; i < threads; i++) {
+    workers.emplace_back(InsertWorker, std::ref(ctx), i);
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  double insert_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  std::atomic<bool> done{false};
+  std::thread scanner(ScanWorker, std::ref(ctx), std::ref(done));
+  workers.clear();
+  for (int i = 0; i < threads; i++) {
+    workers.emplace_back(RemoveWorker, std::ref(ctx), i);
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  double remove_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  done = true;
+  scanner.join();
+
+  // only the even keys are left
+  int count = 0;
+  for (auto it = tree.Begin(); it != tree.End(); ++it) {
+    int k = (*it).second.GetPageId();
+    if (k != count * 2) {
+      LOG(ERROR) << "Expected key " << count * 2 << " but found key " << k << ".";
+      ctx.errors++;
+      break;
+    }
+    count++;
+  }
+  if (count != (total + 1) / 2) {
+    LOG(ERROR) << "Expected " << (total + 1) / 2 << " keys but found " << count << ".";
+    ctx.errors++;
+  }
+  if (!tree.Check()) {
+    ctx.errors++;
+  }
+  tree.Destroy();
+
+  // each key is inserted twice and looked up once, then removed or looked up
+  printf("%2d threads: insert %10.0f ops/s, remove/lookup %10.0f ops/s, %s\n", threads, total * 3 / insert_seconds,
+         total / remove_seconds, ctx.errors == 0 ? "ok" : "FAILED");
+  return ctx.errors == 0;
+}
+
+int main(int argc, char **argv) {
+  FLAGS_logtostderr = true;
+  google::InitGoogleLogging(argv[0]);
+  int threads = argc > 1 ? atoi(argv[1]) : 0;
+  int keys_per_thread = argc > 2 ? atoi(argv[2]) : 10000;
+  uint32_t buffer_pool_size = argc > 3 ? atoi(argv[3]) : 256;
+  mkdir("./databases", 0777);
+
+  bool ok = true;
+  if (threads > 0) {
+    ok = RunStress(threads, keys_per_thread, buffer_pool_size);
+  } else {
+    for (int n = 1; n <= 32; n *= 2) {
+      ok = RunStress(n, keys_per_thread, buffer_pool_size) && ok;
+    }
+  }
+  remove((std::string("./databases/") + kDbName).c_str());
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,567 @@
+#include "buffer/buffer_pool_manager_instance.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "glog/logging.h"
+#include "page/bitmap_page.h"
+
+static const char EMPTY_PAGE_DATA[PAGE_SIZE] = {0};
+
+BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager,
+                                                     BufferPoolManager *owner, ReplacerType replacer_type)
+    : pool_size_(pool_size), disk_manager_(disk_manager), owner_(owner == nullptr ? this : owner) {
+  pages_ = new Page[pool_size_];
+  switch (replacer_type) {
+    case kLRUReplacer:
+      replacer_ = new LRUReplacer(pool_size_);
+      break;
+    case kClockReplacer:
+      replacer_ = new CLOCKReplacer(pool_size_);
+      break;
+    default:
+      replacer_ = new LRUKReplacer(pool_size_);
+      break;
+  }
+  for (size_t i = 0; i < pool_size_; i++) {
+    free_list_.emplace_back(i);
+  }
+  dirty_pos_.assign(pool_size_, dirty_list_.end());
+  flush_buffer_.resize(IO_BATCH_SIZE * PAGE_SIZE);
+  flushing_.assign(pool_size_, false);
+  prefetched_.assign(pool_size_, false);
+  dirty_high_ = pool_size_ * DIRTY_HIGH_WATERMARK / 100;
+  dirty_low_ = pool_size_ * DIRTY_LOW_WATERMARK / 100;
+  flusher_ = thread(&BufferPoolManagerInstance::FlushWorker, this);
+  prefetcher_ = thread(&BufferPoolManagerInstance::PrefetchWorker, this);
+}
+
+BufferPoolManagerInstance::~BufferPoolManagerInstance() {
+  StopBackgroundThreads();
+  for (auto page : page_table_) {
+    FlushPage(page.first);
+  }
+  delete[] pages_;
+  delete replacer_;
+}
+
+void BufferPoolManagerInstance::StopBackgroundThreads() {
+  {
+    scoped_lock<recursive_mutex> lock(latch_);
+    shutdown_ = true;
+  }
+  flusher_cv_.notify_all();
+  prefetch_cv_.notify_all();
+  if (flusher_.joinable()) {
+    flusher_.join();
+  }
+  if (prefetcher_.joinable()) {
+    prefetcher_.join();
+  }
+}
+
+/**
+ * TODO: Student Implement
+ */
+Page *BufferPoolManagerInstance::FetchPage(page_id_t page_id, BufferAccessStrategy *strategy) {
+  scoped_lock<recursive_mutex> lock(latch_);
+  // 1.     Search the page table for the requested page (P).
+  // 1.1    If P exists, pin it and return it immediately.
+  // 1.2    If P does not exist, find a replacement page (R) from either the free list or the replacer.
+  //        Note that pages are always found from the free list first.
+  // 2.     If R is dirty, write it back to the disk.
+  // 3.     Delete R from the page table and insert P.
+  // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
+  if(page_id==CATALOG_META_PAGE_ID) {
+    LOG(INFO) << "Fetching catalog meta page.";
+  }
+  if(page_id==INVALID_PAGE_ID) {
+    LOG(INFO) << "Invalid page id";
+    return nullptr;
+  }
+  auto iter = page_table_.find(page_id);
+  if (iter != page_table_.end()) {
+    frame_id_t frame_id = iter->second;
+    replacer_->Pin(frame_id);
+    pages_[frame_id].pin_count_++;
+    if (prefetched_[frame_id]) {
+      // read ahead on behalf of the access, so it is owned by the ring like a miss would be
+      prefetched_[frame_id] = false;
+      BufferAccessStrategy::Ring *ring = CountStrategyRead(strategy);
+      if (ring != nullptr) {
+        frame_id_t recycled = EvictRingSlot(ring);
+        if (recycled != INVALID_FRAME_ID) {
+          free_list_.push_back(recycled);
+        }
+        AddToRing(ring, page_id);
+      }
+    }
+    return &pages_[frame_id];
+  }
+  BufferAccessStrategy::Ring *ring = CountStrategyRead(strategy);
+  frame_id_t frame_id = ring == nullptr ? INVALID_FRAME_ID : EvictRingSlot(ring);
+  if (frame_id == INVALID_FRAME_ID) {
+    frame_id = TryToFindFreePage();
+  }
+  if (frame_id == INVALID_FRAME_ID) {
+    return nullptr;
+  }
+  Page *page = &pages_[frame_id];
+  page_table_[page_id] = frame_id;
+  page->page_id_ = page_id;
+  page->pin_count_ = 1;
+  page->is_dirty_ = false;
+  disk_manager_->ReadPage(page_id, page->data_);
+  replacer_->Pin(frame_id);
+  if (ring != nullptr) {
+    AddToRing(ring, page_id);
+  }
+  return page;
+}
+
+/**
+ * TODO: Student Implement
+ */
+Page *BufferPoolManagerInstance::NewPage(page_id_t &page_id, BufferAccessStrategy *strategy) {
+  // 0.   Make sure you call AllocatePage!
+  // 1.   If all the pages in the buffer pool are pinned, return nullptr.
+  // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
+  // 3.   Update P's metadata, zero out memory and add P to the page table.
+  // 4.   Set the page ID output parameter. Return a pointer to P.
+  scoped_lock<recursive_mutex> lock(latch_);
+  if (free_list_.empty() && replacer_->Size() == 0) {
+    return nullptr;
+  }
+  page_id = AllocatePage();
+  return NewPageWithId(page_id, strategy);
+}
+
+Page *BufferPoolManagerInstance::NewPageWithId(page_id_t page_id, BufferAccessStrategy *strategy) {
+  scoped_lock<recursive_mutex> lock(latch_);
+  BufferAccessStrategy::Ring *ring = CountStrategyRead(strategy);
+  frame_id_t frame_id = ring == nullptr ? INVALID_FRAME_ID : EvictRingSlot(ring);
+  if (frame_id == INVALID_FRAME_ID) {
+    frame_id = TryToFindFreePage();
+  }
+  if (frame_id == INVALID_FRAME_ID) {
+    return nullptr;
+  }
+  Page *page = &pages_[frame_id];
+  page_table_[page_id] = frame_id;
+  page->ResetMemory();
+  page->page_id_ = page_id;
+  page->pin_count_ = 1;
+  page->is_dirty_ = false;
+  replacer_->Pin(frame_id);
+  if (ring != nullptr) {
+    AddToRing(ring, page_id);
+  }
+  return page;
+}
+
+/**
+ * TODO: Student Implement
+ */
+bool BufferPoolManagerInstance::DeletePage(page_id_t page_id) {
+  unique_lock<recursive_mutex> lock(latch_);
+  WaitForFlush(lock, page_id);
+  // 0.   Make sure you call DeallocatePage!
+  // 1.   Search the page table for the requested page (P).
+  // 1.   If P does not exist, return true.
+  // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
+  // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
+  auto iter = page_table_.find(page_id);
+  if (iter != page_table_.end()) {
+    frame_id_t frame_id = iter->second;
+    Page *page = &pages_[frame_id];
+    if (page->GetPinCount() > 0) {
+      return false;
+    }
+    replacer_->Remove(frame_id);
+    page_table_.erase(iter);
+    page->ResetMemory();
+    page->page_id_ = INVALID_PAGE_ID;
+    MarkClean(frame_id);
+    prefetched_[frame_id] = false;
+    free_list_.push_back(frame_id);
+  }
+  DeallocatePage(page_id);
+  write_epoch_++;
+  return true;
+}
+
+/**
+ * TODO: Student Implement
+ */
+bool BufferPoolManagerInstance::UnpinPage(page_id_t page_id, bool is_dirty) {
+  scoped_lock<recursive_mutex> lock(latch_);
+  auto iter = page_table_.find(page_id);
+  if (iter == page_table_.end()) {
+    return false;
+  }
+  Page *page = &pages_[iter->second];
+  if (page->GetPinCount() <= 0) {
+    return false;
+  }
+  if (is_dirty) {
+    MarkDirty(iter->second);
+  }
+  if (--page->pin_count_ == 0) {
+    replacer_->Unpin(iter->second);
+  }
+  return true;
+}
+
+/**
+ * TODO: Student Implement
+ */
+bool BufferPoolManagerInstance::FlushPage(page_id_t page_id) {
+  unique_lock<recursive_mutex> lock(latch_);
+  WaitForFlush(lock, page_id);
+  auto iter = page_table_.find(page_id);
+  if (iter == page_table_.end()) {
+    return false;
+  }
+  bool written = disk_manager_->WritePage(page_id, pages_[iter->second].data_);
+  write_epoch_++;
+  if (!written) {
+    return false;
+  }
+  MarkClean(iter->second);
+  return true;
+}
+
+/**
+ * Take a frame from the free list, or evict the replacer's victim. The victim's page id is kept in the frame itself,
+ * so its page table entry is dropped without searching the page table.
+ * @return INVALID_FRAME_ID if all frames are pinned, or if the dirty victim could not be written back
+ */
+frame_id_t BufferPoolManagerInstance::TryToFindFreePage() {
+  frame_id_t frame_id;
+  if (!free_list_.empty()) {
+    frame_id = free_list_.front();
+    free_list_.pop_front();
+    return frame_id;
+  }
+  if (!replacer_->Victim(&frame_id)) {
+    return INVALID_FRAME_ID;
+  }
+  prefetched_[frame_id] = false;
+  Page *victim = &pages_[frame_id];
+  if (victim->IsDirty()) {
+    // the flusher fell behind, pay for the write in the foreground
+    bool written = disk_manager_->WritePage(victim->page_id_, victim->data_);
+    write_epoch_++;
+    if (!written) {
+      // keep the page rather than lose its changes
+      LOG(ERROR) << "Failed to write back page " << victim->page_id_ << " before evicting it";
+      replacer_->Unpin(frame_id);
+      return INVALID_FRAME_ID;
+    }
+    MarkClean(frame_id);
+  }
+  page_table_.erase(victim->page_id_);
+  victim->page_id_ = INVALID_PAGE_ID;
+  return frame_id;
+}
+
+BufferAccessStrategy::Ring *BufferPoolManagerInstance::CountStrategyRead(BufferAccessStrategy *strategy) {
+  if (strategy == nullptr) {
+    return nullptr;
+  }
+  BufferAccessStrategy::Ring &ring = strategy->GetRing(this);
+  ring.reads_++;
+  return ring.reads_ > pool_size_ * SCAN_RING_THRESHOLD / 100 ? &ring : nullptr;
+}
+
+/**
+ * The page in the slot may have been fetched by someone else since it was read, in which case it is pinned or has
+ * already been evicted, and the slot is simply overwritten.
+ */
+frame_id_t BufferPoolManagerInstance::EvictRingSlot(BufferAccessStrategy::Ring *ring) {
+  page_id_t page_id = ring->pages_[ring->next_];
+  if (page_id == INVALID_PAGE_ID) {
+    return INVALID_FRAME_ID;
+  }
+  auto iter = page_table_.find(page_id);
+  if (iter == page_table_.end() || pages_[iter->second].pin_count_ > 0) {
+    return INVALID_FRAME_ID;
+  }
+  frame_id_t frame_id = iter->second;
+  Page *page = &pages_[frame_id];
+  if (page->IsDirty()) {
+    bool written = disk_manager_->WritePage(page_id, page->data_);
+    write_epoch_++;
+    if (!written) {
+      // keep the page, the caller falls back to the replacer's victim
+      LOG(ERROR) << "Failed to write back page " << page_id << " before recycling its ring slot";
+      return INVALID_FRAME_ID;
+    }
+    MarkClean(frame_id);
+  }
+  replacer_->Remove(frame_id);
+  page_table_.erase(iter);
+  page->page_id_ = INVALID_PAGE_ID;
+  prefetched_[frame_id] = false;
+  return frame_id;
+}
+
+void BufferPoolManagerInstance::AddToRing(BufferAccessStrategy::Ring *ring, page_id_t page_id) {
+  ring->pages_[ring->next_] = page_id;
+  ring->next_ = (ring->next_ + 1) % ring->pages_.size();
+}
+
+void BufferPoolManagerInstance::MarkDirty(frame_id_t frame_id) {
+  pages_[frame_id].is_dirty_ = true;
+  if (dirty_pos_[frame_id] != dirty_list_.end()) {
+    return;
+  }
+  dirty_pos_[frame_id] = dirty_list_.insert(dirty_list_.end(), frame_id);
+  if (dirty_list_.size() > dirty_high_) {
+    flusher_cv_.notify_one();
+  }
+}
+
+void BufferPoolManagerInstance::MarkClean(frame_id_t frame_id) {
+  pages_[frame_id].is_dirty_ = false;
+  if (dirty_pos_[frame_id] == dirty_list_.end()) {
+    return;
+  }
+  dirty_list_.erase(dirty_pos_[frame_id]);
+  dirty_pos_[frame_id] = dirty_list_.end();
+}
+
+/**
+ * Pinned pages may be modified at any time, so only unpinned pages are chosen. Their content is copied and the frames
+ * are pinned under the latch, then the copies are written without it. The pin keeps the pages from being evicted, and
+ * their frames from being reused, until the write is done. The replacer only holds the frames, so the write does not
+ * count as a reference. The frames are marked clean before the write, so a change
+ * made meanwhile marks them dirty again, and a page whose write failed is marked dirty again afterwards.
+ */
+size_t BufferPoolManagerInstance::FlushDirtyPages(size_t max_pages, unique_lock<recursive_mutex> &lock) {
+  max_pages = min<size_t>(max_pages, IO_BATCH_SIZE);
+  vector<DiskManager::PageIO> writes;
+  vector<frame_id_t> frames;
+  for (auto frame_id : dirty_list_) {
+    if (frames.size() == max_pages) {
+      break;
+    }
+    Page *page = &pages_[frame_id];
+    if (page->pin_count_ == 0) {
+      char *data = &flush_buffer_[frames.size() * PAGE_SIZE];
+      memcpy(data, page->data_, PAGE_SIZE);
+      writes.push_back({page->page_id_, data});
+      frames.push_back(frame_id);
+    }
+  }
+  if (writes.empty()) {
+    return 0;
+  }
+  for (auto frame_id : frames) {
+    MarkClean(frame_id);
+    pages_[frame_id].pin_count_++;
+    replacer_->Hold(frame_id);
+    flushing_[frame_id] = true;
+  }
+  lock.unlock();
+  vector<page_id_t> failed = disk_manager_->WritePages(writes);
+  lock.lock();
+  write_epoch_++;
+  for (auto frame_id : frames) {
+    Page *page = &pages_[frame_id];
+    if (find(failed.begin(), failed.end(), page->page_id_) != failed.end()) {
+      MarkDirty(frame_id);
+    }
+    flushing_[frame_id] = false;
+    if (--page->pin_count_ == 0) {
+      replacer_->Release(frame_id);
+    }
+  }
+  flush_cv_.notify_all();
+  return frames.size() - failed.size();
+}
+
+void BufferPoolManagerInstance::WaitForFlush(unique_lock<recursive_mutex> &lock, page_id_t page_id) {
+  flush_cv_.wait(lock, [this, page_id] {
+    auto iter = page_table_.find(page_id);
+    return iter == page_table_.end() || !flushing_[iter->second];
+  });
+}
+
+/**
+ * Dirty pages are written in batches of IO_BATCH_SIZE. The latch is not held while a batch is written, so foreground
+ * requests only wait for the copy of the pages. The flusher stops early when no page of a batch could be written.
+ */
+void BufferPoolManagerInstance::FlushWorker() {
+  unique_lock<recursive_mutex> lock(latch_);
+  while (!shutdown_) {
+    flusher_cv_.wait_for(lock, chrono::milliseconds(FLUSHER_INTERVAL_MS),
+                         [this] { return shutdown_ || dirty_list_.size() > dirty_high_; });
+    while (!shutdown_ && dirty_list_.size() > dirty_low_ &&
+           FlushDirtyPages(dirty_list_.size() - dirty_low_, lock) > 0) {
+      lock.unlock();
+      this_thread::yield();
+      lock.lock();
+    }
+  }
+}
+
+void BufferPoolManagerInstance::PrefetchPage(page_id_t page_id, size_t chain_length, NextPageFunc next_page) {
+  if (page_id == INVALID_PAGE_ID || chain_length == 0) {
+    return;
+  }
+  scoped_lock<recursive_mutex> lock(latch_);
+  if (shutdown_ || prefetch_queue_.size() >= PREFETCH_QUEUE_SIZE) {
+    return;
+  }
+  prefetch_queue_.push_back({page_id, chain_length, next_page});
+  prefetch_cv_.notify_one();
+}
+
+/**
+ * A request walks its chain through the resident pages right away, as their next pointers are known, so overlapping
+ * read-ahead windows cost no reads. The first page that is not resident is read together with the pages that follow it
+ * in page id order, up to the rest of the chain: heap pages are mostly allocated one after another, so a whole window
+ * usually arrives in one batch of up to IO_BATCH_SIZE pages. Only the pages the chain actually reaches are installed,
+ * and the chain is requeued from the first page the batch did not hold.
+ *
+ * The disk read happens without the latch, so if any page was written back or deleted in the meantime (detected through
+ * write_epoch_) the pages read are discarded rather than installed with stale content. Prefetched pages enter the
+ * replacer without a reference, so they are the first to go if they are never fetched.
+ */
+void BufferPoolManagerInstance::PrefetchWorker() {
+  vector<char> buffer(IO_BATCH_SIZE * PAGE_SIZE);
+  vector<DiskManager::PageIO> reads;
+  unordered_map<page_id_t, char *> read_data;
+  vector<PrefetchRequest> chains;
+  vector<PrefetchRequest> forwards;
+  unique_lock<recursive_mutex> lock(latch_);
+  while (true) {
+    prefetch_cv_.wait(lock, [this] { return shutdown_ || !prefetch_queue_.empty(); });
+    if (shutdown_) {
+      return;
+    }
+    reads.clear();
+    read_data.clear();
+    chains.clear();
+    forwards.clear();
+    while (!prefetch_queue_.empty() && reads.size() < IO_BATCH_SIZE) {
+      PrefetchRequest request = prefetch_queue_.front();
+      prefetch_queue_.pop_front();
+      bool walked = WalkResidentChain(request);
+      if (request.chain_length_ == 0) {
+        continue;
+      }
+      if (walked && owner_ != this) {
+        // the page the walk stopped at may belong to another instance
+        forwards.push_back(request);
+        continue;
+      }
+      chains.push_back(request);
+      for (size_t i = 0; i < request.chain_length_ && reads.size() < IO_BATCH_SIZE; i++) {
+        page_id_t page_id = request.page_id_ + static_cast<page_id_t>(i);
+        if (i > 0 && (owner_ != this || request.next_page_ == nullptr || disk_manager_->IsPageFree(page_id))) {
+          break;
+        }
+        if (page_table_.count(page_id) == 0 && read_data.count(page_id) == 0) {
+          char *data = &buffer[reads.size() * PAGE_SIZE];
+          reads.push_back({page_id, data});
+          read_data[page_id] = data;
+        }
+      }
+    }
+    if (!reads.empty()) {
+      uint64_t epoch = write_epoch_;
+      lock.unlock();
+      disk_manager_->ReadPages(reads);
+      lock.lock();
+      bool install = epoch == write_epoch_;
+      for (auto &request : chains) {
+        while (request.chain_length_ > 0 && request.page_id_ != INVALID_PAGE_ID) {
+          auto iter = read_data.find(request.page_id_);
+          if (iter == read_data.end()) {
+            if (!WalkResidentChain(request)) {
+              break;
+            }
+            continue;
+          }
+          install = install && InstallPrefetchedPage(request.page_id_, iter->second);
+          request.chain_length_--;
+          request.page_id_ = request.chain_length_ > 0 && request.next_page_ != nullptr
+                                 ? request.next_page_(iter->second)
+                                 : INVALID_PAGE_ID;
+        }
+        if (request.chain_length_ > 0 && request.page_id_ != INVALID_PAGE_ID) {
+          forwards.push_back(request);
+        }
+      }
+    }
+    // the next pages may belong to another instance, forward without holding the latch
+    lock.unlock();
+    for (const auto &request : forwards) {
+      owner_->PrefetchPage(request.page_id_, request.chain_length_, request.next_page_);
+    }
+    lock.lock();
+  }
+}
+
+bool BufferPoolManagerInstance::WalkResidentChain(PrefetchRequest &request) {
+  bool walked = false;
+  while (request.chain_length_ > 0 && request.page_id_ != INVALID_PAGE_ID) {
+    auto iter = page_table_.find(request.page_id_);
+    if (iter == page_table_.end()) {
+      return walked;
+    }
+    walked = true;
+    request.chain_length_--;
+    request.page_id_ = request.chain_length_ > 0 && request.next_page_ != nullptr
+                           ? request.next_page_(pages_[iter->second].data_)
+                           : INVALID_PAGE_ID;
+  }
+  request.chain_length_ = 0;
+  return walked;
+}
+
+bool BufferPoolManagerInstance::InstallPrefetchedPage(page_id_t page_id, const char *data) {
+  if (page_table_.count(page_id) != 0) {
+    return true;
+  }
+  frame_id_t frame_id = TryToFindFreePage();
+  if (frame_id == INVALID_FRAME_ID) {
+    return false;
+  }
+  Page *page = &pages_[frame_id];
+  page_table_[page_id] = frame_id;
+  memcpy(page->data_, data, PAGE_SIZE);
+  page->page_id_ = page_id;
+  page->pin_count_ = 0;
+  page->is_dirty_ = false;
+  prefetched_[frame_id] = true;
+  replacer_->Unpin(frame_id);
+  return true;
+}
+
+page_id_t BufferPoolManagerInstance::AllocatePage() {
+  int next_page_id = disk_manager_->AllocatePage();
+  return next_page_id;
+}
+
+void BufferPoolManagerInstance::DeallocatePage(__attribute__((unused)) page_id_t page_id) {
+  disk_manager_->DeAllocatePage(page_id);
+}
+
+bool BufferPoolManagerInstance::IsPageFree(page_id_t page_id) {
+  return disk_manager_->IsPageFree(page_id);
+}
+
+// Only used for debug
+bool BufferPoolManagerInstance::CheckAllUnpinned() {
+  bool res = true;
+  for (size_t i = 0; i < pool_size_; i++) {
+    if (pages_[i].pin_count_ != 0) {
+      res = false;
+      LOG(ERROR) << "page " << pages_[i].page_id_ << " pin count:" << pages_[i].pin_count_ << endl;
+    }
+  }
+  return res;
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "buffer/clock_replacer.h"
+
+CLOCKReplacer::CLOCKReplacer(size_t num_pages)
+    : capacity_(num_pages), in_replacer_(num_pages, false), referenced_(num_pages, false) {}
+
+CLOCKReplacer::~CLOCKReplacer() = default;
+
+/**
+ * The hand clears the reference bits it passes, so it finds a victim within two turns.
+ */
+bool CLOCKReplacer::Victim(frame_id_t *frame_id) {
+  lock_guard<mutex> guard(latch_);
+  if (size_ == 0) {
+    return false;
+  }
+  while (true) {
+    size_t frame = hand_;
+    hand_ = (hand_ + 1) % capacity_;
+    if (!in_replacer_[frame]) {
+      continue;
+    }
+    if (referenced_[frame]) {
+      referenced_[frame] = false;
+      continue;
+    }
+    in_replacer_[frame] = false;
+    size_--;
+    *frame_id = static_cast<frame_id_t>(frame);
+    return true;
+  }
+}
+
+void CLOCKReplacer::Pin(frame_id_t frame_id) {
+  lock_guard<mutex> guard(latch_);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= capacity_) {
+    return;
+  }
+  if (in_replacer_[frame_id]) {
+    in_replacer_[frame_id] = false;
+    size_--;
+  }
+  referenced_[frame_id] = true;
+}
+
+/**
+ * A prefetched frame is unpinned without a pin, so it stays unreferenced and is the first the hand takes.
+ */
+void CLOCKReplacer::Unpin(frame_id_t frame_id) {
+  lock_guard<mutex> guard(latch_);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= capacity_ || in_replacer_[frame_id]) {
+    return;
+  }
+  in_replacer_[frame_id] = true;
+  size_++;
+}
+
+void CLOCKReplacer::Remove(frame_id_t frame_id) {
+  lock_guard<mutex> guard(latch_);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= capacity_) {
+    return;
+  }
+  if (in_replacer_[frame_id]) {
+    in_replacer_[frame_id] = false;
+    size_--;
+  }
+  referenced_[frame_id] = false;
+}
+
+/**
+ * Unlike Pin, the reference bit is left alone, so holding a frame does not give it a second chance.
+ */
+void CLOCKReplacer::Hold(frame_id_t frame_id) {
+  lock_guard<mutex> guard(latch_);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= capacity_) {
+    return;
+  }
+  if (in_replacer_[frame_id]) {
+    in_replacer_[frame_id] = false;
+    size_--;
+  }
+}
+
+size_t CLOCKReplacer::Size() {
+  lock_guard<mutex> guard(latch_);
+  return size_;
+}
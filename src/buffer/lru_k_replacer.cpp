@@ -0,0 +1,162 @@
+#include "buffer/lru_k_replacer.h"
+
+LRUKReplacer::LRUKReplacer(size_t num_pages, size_t k, size_t correlated_period)
+    : k_(k == 0 ? 1 : k), correlated_period_(correlated_period), frames_(num_pages) {}
+
+LRUKReplacer::~LRUKReplacer() = default;
+
+/**
+ * Frames in the history list have an infinite backward k-distance, so they are always evicted before the frames in
+ * the cache set.
+ */
+bool LRUKReplacer::Victim(frame_id_t *frame_id) {
+  lock_guard<mutex> guard(latch_);
+  if (size_ == 0) {
+    return false;
+  }
+  auto history_iter = history_list_.begin();
+  while (history_iter != history_list_.end() && frames_[*history_iter].held_) {
+    ++history_iter;
+  }
+  if (history_iter != history_list_.end()) {
+    *frame_id = *history_iter;
+    history_list_.erase(history_iter);
+  } else {
+    auto cache_iter = cache_set_.begin();
+    while (frames_[cache_iter->second].held_) {
+      ++cache_iter;
+    }
+    *frame_id = cache_iter->second;
+    cache_set_.erase(cache_iter);
+  }
+  // the frame will hold a different page, forget its reference history
+  frames_[*frame_id] = FrameEntry();
+  size_--;
+  return true;
+}
+
+/**
+ * Every pin is a reference to the page held by the frame, unless it is correlated with the last reference. A new
+ * uncorrelated reference shifts the older ones by the length of the correlated run that ended, so that a run counts
+ * as a single point in time, as in the original LRU-K.
+ */
+void LRUKReplacer::Pin(frame_id_t frame_id) {
+  lock_guard<mutex> guard(latch_);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= frames_.size()) {
+    return;
+  }
+  FrameEntry &entry = frames_[frame_id];
+  if (entry.evictable_) {
+    Erase(entry, frame_id);
+    entry.evictable_ = false;
+    if (!entry.held_) {
+      size_--;
+    }
+    entry.held_ = false;
+  }
+  uint64_t now = Now();
+  if (!entry.history_.empty() && now - entry.history_.front() <= correlated_period_) {
+    entry.last_ = now;
+    return;
+  }
+  if (!entry.history_.empty()) {
+    uint64_t run_length = entry.last_ - entry.history_.front();
+    for (auto &time : entry.history_) {
+      time += run_length;
+    }
+  }
+  entry.history_.insert(entry.history_.begin(), now);
+  if (entry.history_.size() > k_) {
+    entry.history_.pop_back();
+  }
+  entry.last_ = now;
+}
+
+/**
+ * Once unpinned, a frame is queued at the back of the history list, or enters the cache set at its k-th most recent
+ * reference.
+ */
+void LRUKReplacer::Unpin(frame_id_t frame_id) {
+  lock_guard<mutex> guard(latch_);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= frames_.size()) {
+    return;
+  }
+  FrameEntry &entry = frames_[frame_id];
+  if (entry.evictable_) {
+    return;
+  }
+  // a prefetched frame has never been pinned, it stays at zero references in the history list
+  if (entry.history_.size() < k_) {
+    entry.pos_ = history_list_.insert(history_list_.end(), frame_id);
+  } else {
+    cache_set_.emplace(entry.history_.back(), frame_id);
+  }
+  entry.evictable_ = true;
+  size_++;
+}
+
+/**
+ * Unlike Pin, the reference history of the frame is dropped as well.
+ */
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+  lock_guard<mutex> guard(latch_);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= frames_.size()) {
+    return;
+  }
+  FrameEntry &entry = frames_[frame_id];
+  if (entry.evictable_) {
+    Erase(entry, frame_id);
+    if (!entry.held_) {
+      size_--;
+    }
+  }
+  entry = FrameEntry();
+}
+
+/**
+ * The frame stays where it is in the history list or the cache set, and its reference history is left alone.
+ */
+void LRUKReplacer::Hold(frame_id_t frame_id) {
+  lock_guard<mutex> guard(latch_);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= frames_.size()) {
+    return;
+  }
+  FrameEntry &entry = frames_[frame_id];
+  if (entry.evictable_ && !entry.held_) {
+    entry.held_ = true;
+    size_--;
+  }
+}
+
+void LRUKReplacer::Release(frame_id_t frame_id) {
+  {
+    lock_guard<mutex> guard(latch_);
+    if (frame_id < 0 || static_cast<size_t>(frame_id) >= frames_.size()) {
+      return;
+    }
+    FrameEntry &entry = frames_[frame_id];
+    if (entry.held_) {
+      entry.held_ = false;
+      size_++;
+      return;
+    }
+  }
+  Unpin(frame_id);
+}
+
+size_t LRUKReplacer::Size() {
+  lock_guard<mutex> guard(latch_);
+  return size_;
+}
+
+uint64_t LRUKReplacer::Now() {
+  return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void LRUKReplacer::Erase(FrameEntry &entry, frame_id_t frame_id) {
+  if (entry.history_.size() < k_) {
+    history_list_.erase(entry.pos_);
+  } else {
+    cache_set_.erase({entry.history_.back(), frame_id});
+  }
+}
@@ -8,15 +8,19 @@ LRUReplacer::~LRUReplacer() = default;
  * TODO: Student Implement
  */
 bool LRUReplacer::Victim(frame_id_t *frame_id) {
-  if(lru_list_.size()==0) return false;
-  *frame_id = lru_list_.back();
-  lru_list_.pop_back();
-  return true;
+  for(auto it = lru_list_.rbegin();it!=lru_list_.rend();it++){
+    if(held_.count(*it)) continue;
+    *frame_id = *it;
+    lru_list_.erase(next(it).base());
+    return true;
+  }
+  return false;
 }
 /**
  * TODO: Student Implement
  */
 void LRUReplacer::Pin(frame_id_t frame_id) {
+  held_.erase(frame_id);
   for(auto it = lru_list_.begin();it!=lru_list_.end();it++){
     if(*it==frame_id) {lru_list_.erase(it);break;}
   }
@@ -32,9 +36,23 @@ void LRUReplacer::Unpin(frame_id_t frame_id) {
   lru_list_.push_front(frame_id);
 }
 
+/**
+ * The frame keeps its place in the list.
+ */
+void LRUReplacer::Hold(frame_id_t frame_id) {
+  for(auto it = lru_list_.begin();it!=lru_list_.end();it++){
+    if(*it==frame_id) {held_.insert(frame_id);return;}
+  }
+}
+
+void LRUReplacer::Release(frame_id_t frame_id) {
+  if(held_.erase(frame_id)) return;
+  Unpin(frame_id);
+}
+
 /**
  * TODO: Student Implement
  */
 size_t LRUReplacer::Size() {
-  return lru_list_.size();
+  return lru_list_.size() - held_.size();
 }
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "buffer/mmap_buffer_pool_manager.h"
+
+#include <sys/mman.h>
+
+#include <new>
+#include <stdexcept>
+
+#include "glog/logging.h"
+
+/**
+ * Only address space is reserved here. The anonymous memory of a slot is committed when its page is first fetched.
+ */
+MmapBufferPoolManager::MmapBufferPoolManager(DiskManager *disk_manager) : disk_manager_(disk_manager) {
+  // physical pages include the bitmap pages, so every logical page id of the file is below this
+  num_slots_ = disk_manager_->GetPhysicalPageCount();
+  if (num_slots_ == 0) {
+    num_slots_ = 1;
+  }
+  void *slots = mmap(nullptr, num_slots_ * SLOT_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                     -1, 0);
+  if (slots == MAP_FAILED) {
+    LOG(ERROR) << "Failed to reserve address space for the read-only buffer pool.";
+    throw std::exception();
+  }
+  slots_ = static_cast<char *>(slots);
+  mapped_.assign(num_slots_, false);
+}
+
+MmapBufferPoolManager::~MmapBufferPoolManager() { munmap(slots_, num_slots_ * SLOT_SIZE); }
+
+Page *MmapBufferPoolManager::FetchPage(page_id_t page_id, BufferAccessStrategy *strategy) {
+  if (page_id < 0 || static_cast<size_t>(page_id) >= num_slots_) {
+    LOG(WARNING) << "Page " << page_id << " is not in the read-only database file.";
+    return nullptr;
+  }
+  scoped_lock<mutex> lock(latch_);
+  Page *page = GetSlot(page_id);
+  if (!mapped_[page_id]) {
+    if (!disk_manager_->MapPage(page_id, page->data_)) {
+      if (!map_failed_) {
+        LOG(WARNING) << "Failed to map page " << page_id << ", falling back to reading pages.";
+        map_failed_ = true;
+      }
+      disk_manager_->ReadPage(page_id, page->data_);
+    }
+    new (&page->rwlatch_) ReaderWriterLatch();
+    page->page_id_ = page_id;
+    page->pin_count_ = 0;
+    page->is_dirty_ = false;
+    mapped_[page_id] = true;
+  }
+  page->pin_count_++;
+  return page;
+}
+
+bool MmapBufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
+  if (page_id < 0 || static_cast<size_t>(page_id) >= num_slots_) {
+    return false;
+  }
+  scoped_lock<mutex> lock(latch_);
+  Page *page = GetSlot(page_id);
+  if (!mapped_[page_id] || page->pin_count_ <= 0) {
+    return false;
+  }
+  if (is_dirty) {
+    LOG(WARNING) << "Read-only buffer pool, changes to page " << page_id << " are discarded.";
+  }
+  page->pin_count_--;
+  return true;
+}
+
+bool MmapBufferPoolManager::FlushPage(page_id_t page_id) { return false; }
+
+Page *MmapBufferPoolManager::NewPage(page_id_t &page_id, BufferAccessStrategy *strategy) {
+  LOG(ERROR) << "Cannot allocate pages in a read-only buffer pool.";
+  return nullptr;
+}
+
+bool MmapBufferPoolManager::DeletePage(page_id_t page_id) {
+  LOG(ERROR) << "Cannot delete pages in a read-only buffer pool.";
+  return false;
+}
+
+bool MmapBufferPoolManager::IsPageFree(page_id_t page_id) { return disk_manager_->IsPageFree(page_id); }
+
+// Only used for debug
+bool MmapBufferPoolManager::CheckAllUnpinned() {
+  scoped_lock<mutex> lock(latch_);
+  bool res = true;
+  for (size_t i = 0; i < num_slots_; i++) {
+    if (mapped_[i] && GetSlot(i)->pin_count_ != 0) {
+      res = false;
+      LOG(ERROR) << "page " << i << " pin count:" << GetSlot(i)->pin_count_ << endl;
+    }
+  }
+  return res;
+}
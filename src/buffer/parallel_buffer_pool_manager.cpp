@@ -0,0 +1,87 @@
+#include "buffer/parallel_buffer_pool_manager.h"
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size,
+                                                     DiskManager *disk_manager, ReplacerType replacer_type)
+    : disk_manager_(disk_manager) {
+  if (num_instances == 0) {
+    num_instances = 1;
+  }
+  instances_.reserve(num_instances);
+  for (size_t i = 0; i < num_instances; i++) {
+    // the first pool_size % num_instances shards take one of the remaining frames each
+    size_t instance_size = pool_size / num_instances + (i < pool_size % num_instances ? 1 : 0);
+    if (instance_size == 0) {
+      instance_size = 1;
+    }
+    instances_.emplace_back(new BufferPoolManagerInstance(instance_size, disk_manager_, this, replacer_type));
+  }
+}
+
+ParallelBufferPoolManager::~ParallelBufferPoolManager() {
+  // a prefetcher may forward a hint to any instance, so none is deleted before all of them are stopped
+  for (auto instance : instances_) {
+    instance->StopBackgroundThreads();
+  }
+  for (auto instance : instances_) {
+    delete instance;
+  }
+}
+
+Page *ParallelBufferPoolManager::FetchPage(page_id_t page_id, BufferAccessStrategy *strategy) {
+  return GetInstance(page_id)->FetchPage(page_id, strategy);
+}
+
+bool ParallelBufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
+  return GetInstance(page_id)->UnpinPage(page_id, is_dirty);
+}
+
+bool ParallelBufferPoolManager::FlushPage(page_id_t page_id) {
+  return GetInstance(page_id)->FlushPage(page_id);
+}
+
+/**
+ * The disk manager decides which page id is allocated, so the page is allocated first and then handed to the
+ * instance owning that id. If the owning instance has no frame left, the allocation is rolled back.
+ */
+Page *ParallelBufferPoolManager::NewPage(page_id_t &page_id, BufferAccessStrategy *strategy) {
+  page_id_t new_page_id = disk_manager_->AllocatePage();
+  Page *page = GetInstance(new_page_id)->NewPageWithId(new_page_id, strategy);
+  if (page == nullptr) {
+    disk_manager_->DeAllocatePage(new_page_id);
+    return nullptr;
+  }
+  page_id = new_page_id;
+  return page;
+}
+
+bool ParallelBufferPoolManager::DeletePage(page_id_t page_id) {
+  return GetInstance(page_id)->DeletePage(page_id);
+}
+
+bool ParallelBufferPoolManager::IsPageFree(page_id_t page_id) {
+  return disk_manager_->IsPageFree(page_id);
+}
+
+size_t ParallelBufferPoolManager::GetPoolSize() {
+  size_t pool_size = 0;
+  for (auto instance : instances_) {
+    pool_size += instance->GetPoolSize();
+  }
+  return pool_size;
+}
+
+void ParallelBufferPoolManager::PrefetchPage(page_id_t page_id, size_t chain_length, NextPageFunc next_page) {
+  if (page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  GetInstance(page_id)->PrefetchPage(page_id, chain_length, next_page);
+}
+
+// Only used for debug
+bool ParallelBufferPoolManager::CheckAllUnpinned() {
+  bool res = true;
+  for (auto instance : instances_) {
+    res = instance->CheckAllUnpinned() && res;
+  }
+  return res;
+}
@@ -113,14 +113,19 @@ CatalogManager::~CatalogManager() {
  * TODO: Student Implement
  */
 dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schema, Txn *txn, TableInfo *&table_info) {
-  table_id_t table_id = next_table_id_++;
-  table_names_[table_name] = table_id;
-  table_info = TableInfo::Create();
   page_id_t table_meta_page_id;
   Page* table_meta_page = buffer_pool_manager_->NewPage(table_meta_page_id);
+  if (table_meta_page == nullptr) {
+    LOG(ERROR) << "Failed to allocate the metadata page of table " << table_name;
+    return DB_FAILED;
+  }
   LOG(INFO)<< "Create new page for table metadata, page id: " << table_meta_page_id;
-  TableMetadata *table_meta = TableMetadata::Create(table_id, table_name, table_meta_page_id, TableSchema::DeepCopySchema(schema));
-  TableHeap *table_heap = TableHeap::Create(buffer_pool_manager_, table_meta->GetSchema(), txn, log_manager_, lock_manager_);
+  table_id_t table_id = next_table_id_++;
+  table_names_[table_name] = table_id;
+  table_info = TableInfo::Create();
+  TableSchema *table_schema = TableSchema::DeepCopySchema(schema);
+  TableHeap *table_heap = TableHeap::Create(buffer_pool_manager_, table_schema, txn, log_manager_, lock_manager_);
+  TableMetadata *table_meta = TableMetadata::Create(table_id, table_name, table_heap->GetFirstPageId(), table_schema);
   table_info->Init(table_meta,table_heap);
   tables_[table_id] = table_info;
   catalog_meta_->table_meta_pages_[table_id] = table_meta_page_id;
@@ -161,7 +166,7 @@ dberr_t CatalogManager::GetTables(vector<TableInfo *> &tables) const {
  */
 dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string &index_name,
                                     const std::vector<std::string> &index_keys, Txn *txn, IndexInfo *&index_info,
-                                    const string &index_type) {
+                                    const string &index_type, bool unique) {
   if (index_names_.find(table_name) == index_names_.end()) return DB_TABLE_NOT_EXIST;
   if (index_names_[table_name].find(index_name) != index_names_[table_name].end()) return DB_INDEX_ALREADY_EXIST;
   
@@ -181,8 +186,29 @@ dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string
   page_id_t index_meta_page_id;
   Page* index_meta_page = buffer_pool_manager_->NewPage(index_meta_page_id);
   LOG(INFO)<< "Create new page for index metadata, page id: " << index_meta_page_id;
-  IndexMetadata *index_meta = IndexMetadata::Create(index_id, index_name, table_names_[table_name], key_map);
-  index_info->Init(index_meta,tables_[table_names_[table_name]], buffer_pool_manager_);
+  IndexMetadata *index_meta = IndexMetadata::Create(index_id, index_name, table_names_[table_name], key_map, unique);
+  TableInfo *table_info = tables_[table_names_[table_name]];
+  index_info->Init(index_meta, table_info, buffer_pool_manager_);
+  // index the rows already in the table, a unique index over duplicate keys is dropped again
+  try {
+    db_result = index_info->GetIndex()->BulkLoad(table_info->GetTableHeap(), table_info->GetSchema(), txn);
+  } catch (const std::exception &e) {
+    LOG(ERROR) << "Failed to build index " << index_name << ": " << e.what();
+    db_result = DB_FAILED;
+  }
+  if (db_result != DB_SUCCESS) {
+    if (db_result == DB_ALREADY_EXIST) {
+      LOG(WARNING) << "Failed to build index " << index_name << ", the rows of table " << table_name
+                   << " have duplicate keys.";
+    }
+    index_info->GetIndex()->Destroy();
+    delete index_info;
+    index_info = nullptr;
+    index_names_[table_name].erase(index_name);
+    buffer_pool_manager_->UnpinPage(index_meta_page_id, false);
+    buffer_pool_manager_->DeletePage(index_meta_page_id);
+    return DB_FAILED;
+  }
   indexes_[index_id] = index_info;
   catalog_meta_->index_meta_pages_[index_id] = index_meta_page_id;
   index_meta->SerializeTo(index_meta_page->GetData());
@@ -277,7 +303,9 @@ dberr_t CatalogManager::LoadTable(const table_id_t table_id, const page_id_t pag
   Page *page = buffer_pool_manager_->FetchPage(page_id);
   TableMetadata *table_meta=nullptr;
   TableMetadata::DeserializeFrom(page->GetData(),table_meta);
-  TableHeap *table_heap = TableHeap::Create(buffer_pool_manager_, table_meta->GetSchema(), nullptr, log_manager_, lock_manager_);
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  TableHeap *table_heap = TableHeap::Create(buffer_pool_manager_, table_meta->GetFirstPageId(), table_meta->GetSchema(),
+                                            log_manager_, lock_manager_);
   table_info->Init(table_meta, table_heap);
   tables_[table_id] = table_info;
   table_names_[table_meta->GetTableName()] = table_id;
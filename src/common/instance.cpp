@@ -3,16 +3,24 @@
 //
 #include "common/instance.h"
 
-DBStorageEngine::DBStorageEngine(std::string db_name, bool init, uint32_t buffer_pool_size)
-    : db_file_name_(std::move(db_name)), init_(init) {
+DBStorageEngine::DBStorageEngine(std::string db_name, bool init, uint32_t buffer_pool_size,
+                                 uint32_t buffer_pool_instances, bool read_only)
+    : db_file_name_(std::move(db_name)), init_(init), read_only_(read_only && !init) {
+  read_only = read_only_;
   // Init database file if needed
   db_file_name_ = "./databases/" + db_file_name_;
   if (init_) {
     remove(db_file_name_.c_str());
   }
   // Initialize components
-  disk_mgr_ = new DiskManager(db_file_name_);
-  bpm_ = new BufferPoolManager(buffer_pool_size, disk_mgr_);
+  disk_mgr_ = new DiskManager(db_file_name_, ENABLE_DIRECT_IO && !read_only, read_only);
+  if (read_only) {
+    bpm_ = new MmapBufferPoolManager(disk_mgr_);
+  } else if (buffer_pool_instances > 1) {
+    bpm_ = new ParallelBufferPoolManager(buffer_pool_instances, buffer_pool_size, disk_mgr_);
+  } else {
+    bpm_ = new BufferPoolManagerInstance(buffer_pool_size, disk_mgr_);
+  }
 
   // Allocate static page for db storage engine
   if (init) {
@@ -16,16 +16,33 @@ void DeleteExecutor::Init() {
 }
 
 bool DeleteExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
-  if (child_executor_->Next(row, rid)) {
-    if (!table_info_->GetTableHeap()->MarkDelete(*rid, txn_)) {
-      return false;
-    }
-    Row key_row;
-    for (auto info : index_info_) {  // 更新索引
-      row->GetKeyFromRow(table_info_->GetSchema(), info->GetIndexKeySchema(), key_row);
-      info->GetIndex()->RemoveEntry(key_row, *rid, txn_);
+  return child_executor_->Next(row, rid) && DeleteRow(*row, *rid);
+}
+
+bool DeleteExecutor::NextBatch(RowBatch *batch) {
+  if (done_ || !child_executor_->NextBatch(batch)) {
+    return false;
+  }
+  auto &selection = batch->GetSelection();
+  for (size_t i = 0; i < selection.size(); i++) {
+    Row &row = batch->GetRow(selection[i]);
+    if (!DeleteRow(row, row.GetRowId())) {
+      selection.resize(i);
+      done_ = true;
+      break;
     }
-    return true;
   }
-  return false;
-}
\ No newline at end of file
+  return !selection.empty();
+}
+
+bool DeleteExecutor::DeleteRow(Row &row, const RowId &rid) {
+  if (!table_info_->GetTableHeap()->MarkDelete(rid, txn_)) {
+    return false;
+  }
+  Row key_row;
+  for (auto info : index_info_) {  // 更新索引
+    row.GetKeyFromRow(table_info_->GetSchema(), info->GetIndexKeySchema(), key_row);
+    info->GetIndex()->RemoveEntry(key_row, rid, txn_);
+  }
+  return true;
+}
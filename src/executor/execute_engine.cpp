@@ -8,8 +8,11 @@
 
 #include "common/result_writer.h"
 #include "executor/executors/delete_executor.h"
+#include "executor/executors/hash_join_executor.h"
+#include "executor/executors/index_only_scan_executor.h"
 #include "executor/executors/index_scan_executor.h"
 #include "executor/executors/insert_executor.h"
+#include "executor/executors/nested_index_join_executor.h"
 #include "executor/executors/seq_scan_executor.h"
 #include "executor/executors/update_executor.h"
 #include "executor/executors/values_executor.h"
@@ -50,6 +53,11 @@ std::unique_ptr<AbstractExecutor> ExecuteEngine::CreateExecutor(ExecuteContext *
     case PlanType::IndexScan: {
       return std::make_unique<IndexScanExecutor>(exec_ctx, dynamic_cast<const IndexScanPlanNode *>(plan.get()));
     }
+    // Create a new index only scan executor
+    case PlanType::IndexOnlyScan: {
+      return std::make_unique<IndexOnlyScanExecutor>(exec_ctx,
+                                                     dynamic_cast<const IndexOnlyScanPlanNode *>(plan.get()));
+    }
     // Create a new update executor
     case PlanType::Update: {
       auto update_plan = dynamic_cast<const UpdatePlanNode *>(plan.get());
@@ -70,6 +78,20 @@ std::unique_ptr<AbstractExecutor> ExecuteEngine::CreateExecutor(ExecuteContext *
     case PlanType::Values: {
       return std::make_unique<ValuesExecutor>(exec_ctx, dynamic_cast<const ValuesPlanNode *>(plan.get()));
     }
+    // Create a new hash join executor
+    case PlanType::HashJoin: {
+      auto join_plan = dynamic_cast<const HashJoinPlanNode *>(plan.get());
+      auto left_executor = CreateExecutor(exec_ctx, join_plan->GetLeftPlan());
+      auto right_executor = CreateExecutor(exec_ctx, join_plan->GetRightPlan());
+      return std::make_unique<HashJoinExecutor>(exec_ctx, join_plan, std::move(left_executor),
+                                                std::move(right_executor));
+    }
+    // Create a new nested index join executor
+    case PlanType::NestedIndexJoin: {
+      auto join_plan = dynamic_cast<const NestedIndexJoinPlanNode *>(plan.get());
+      auto child_executor = CreateExecutor(exec_ctx, join_plan->GetChildPlan());
+      return std::make_unique<NestedIndexJoinExecutor>(exec_ctx, join_plan, std::move(child_executor));
+    }
     default:
       throw std::logic_error("Unsupported plan type.");
   }
@@ -82,11 +104,12 @@ dberr_t ExecuteEngine::ExecutePlan(const AbstractPlanNodeRef &plan, std::vector<
 
   try {
     executor->Init();
-    RowId rid{};
-    Row row{};
-    while (executor->Next(&row, &rid)) {
+    RowBatch batch;
+    while (executor->NextBatch(&batch)) {
       if (result_set != nullptr) {
-        result_set->push_back(row);
+        for (auto idx : batch.GetSelection()) {
+          result_set->push_back(batch.GetRow(idx));
+        }
       }
     }
   } catch (const exception &ex) {
@@ -106,6 +129,22 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast) {
   auto start_time = std::chrono::system_clock::now();
   unique_ptr<ExecuteContext> context(nullptr);
   if (!current_db_.empty()) context = dbs_[current_db_]->MakeExecuteContext(nullptr);
+  if (context != nullptr) context->SetAccessStrategy(bulk_strategy_);
+  // a read-only database is served from a private mapping of its file, any change would be silently dropped
+  if (!current_db_.empty() && dbs_[current_db_]->read_only_) {
+    switch (ast->type_) {
+      case kNodeCreateTable:
+      case kNodeDropTable:
+      case kNodeCreateIndex:
+      case kNodeDropIndex:
+      case kNodeInsert:
+      case kNodeDelete:
+      case kNodeUpdate:
+        return DB_READ_ONLY;
+      default:
+        break;
+    }
+  }
   switch (ast->type_) {
     case kNodeCreateDB:
       return ExecuteCreateDatabase(ast, context.get());
@@ -158,7 +197,9 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast) {
   std::stringstream ss;
   ResultWriter writer(ss);
 
-  if (planner.plan_->GetType() == PlanType::SeqScan || planner.plan_->GetType() == PlanType::IndexScan) {
+  auto plan_type = planner.plan_->GetType();
+  if (plan_type == PlanType::SeqScan || plan_type == PlanType::IndexScan || plan_type == PlanType::IndexOnlyScan ||
+      plan_type == PlanType::HashJoin || plan_type == PlanType::NestedIndexJoin) {
     auto schema = planner.plan_->OutputSchema();
     auto num_of_columns = schema->GetColumnCount();
     if (!result_set.empty()) {
@@ -231,6 +272,9 @@ void ExecuteEngine::ExecuteInformation(dberr_t result) {
     case DB_KEY_NOT_FOUND:
       cout << "Key not exists." << endl;
       break;
+    case DB_READ_ONLY:
+      cout << "Database is read-only." << endl;
+      break;
     case DB_QUIT:
       cout << "Bye." << endl;
       break;
@@ -259,6 +303,9 @@ dberr_t ExecuteEngine::ExecuteDropDatabase(pSyntaxNode ast, ExecuteContext *cont
   if (dbs_.find(db_name) == dbs_.end()) {
     return DB_NOT_EXIST;
   }
+  if (dbs_[db_name]->read_only_) {
+    return DB_READ_ONLY;
+  }
   remove(("./databases/" + db_name).c_str());
   delete dbs_[db_name];
   dbs_.erase(db_name);
@@ -459,8 +506,25 @@ dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *conte
   if(cur!=nullptr){
     index_type = cur->child_->val_;
   }
+  // the index is unique if one of its columns is, otherwise it may hold duplicate keys
+  TableInfo *tableinfo;
+  if (dbs_[current_db_]->catalog_mgr_->GetTable(tablename, tableinfo) != DB_SUCCESS) return DB_TABLE_NOT_EXIST;
+  bool unique = false;
+  for (auto &key : index_keys) {
+    uint32_t column_index;
+    if (tableinfo->GetSchema()->GetColumnIndex(key, column_index) == DB_SUCCESS &&
+        tableinfo->GetSchema()->GetColumn(column_index)->IsUnique()) {
+      unique = true;
+    }
+  }
   IndexInfo* indexinfo;
-  return dbs_[current_db_]->catalog_mgr_->CreateIndex(tablename,indexname,index_keys,nullptr,indexinfo,index_type);
+  auto catalog = dbs_[current_db_]->catalog_mgr_;
+  dberr_t result = catalog->CreateIndex(tablename, indexname, index_keys, nullptr, indexinfo, index_type, unique);
+  if (result == DB_FAILED) {
+    cout << "Duplicate keys in the rows of table " << tablename << ", unique index " << indexname << " not created."
+         << endl;
+  }
+  return result;
 }
 
 /**
@@ -533,6 +597,10 @@ dberr_t ExecuteEngine::ExecuteExecfile(pSyntaxNode ast, ExecuteContext *context)
   
   ExecuteEngine engine;
   for(const string& statement:statements){
+    // each statement of a script gets its own strategy, a large one recycles a ring of frames once it outgrows the
+    // pool without the reads of the earlier statements, or of other tables, pushing it there
+    BufferAccessStrategy statement_strategy;
+    engine.bulk_strategy_ = &statement_strategy;
     // read from buffer
     // create buffer for sql input
     YY_BUFFER_STATE bp = yy_scan_string(statement.c_str());
@@ -563,6 +631,7 @@ dberr_t ExecuteEngine::ExecuteExecfile(pSyntaxNode ast, ExecuteContext *context)
 
     // quit condition
     engine.ExecuteInformation(result);
+    engine.bulk_strategy_ = nullptr;
     if (result == DB_QUIT) {
       break;
     }
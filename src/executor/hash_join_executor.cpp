@@ -0,0 +1,280 @@
+#include "executor/executors/hash_join_executor.h"
+
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <tuple>
+
+#include "glog/logging.h"
+
+HashJoinExecutor::HashJoinExecutor(ExecuteContext *exec_ctx, const HashJoinPlanNode *plan,
+                                   std::unique_ptr<AbstractExecutor> &&left_executor,
+                                   std::unique_ptr<AbstractExecutor> &&right_executor, size_t memory_limit)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      children_{std::move(left_executor), std::move(right_executor)},
+      memory_limit_(memory_limit) {}
+
+HashJoinExecutor::~HashJoinExecutor() {
+  for (auto &partition : partitions_) {
+    for (auto file : partition.files_) {
+      if (file != nullptr) {
+        fclose(file);
+      }
+    }
+  }
+}
+
+void HashJoinExecutor::Init() {
+  children_[0]->Init();
+  children_[1]->Init();
+  const auto &output_columns = plan_->OutputSchema()->GetColumns();
+  size_t width = children_[0]->GetOutputSchema()->GetColumnCount() + children_[1]->GetOutputSchema()->GetColumnCount();
+  is_schema_same_ = output_columns.size() == width;
+  for (size_t i = 0; is_schema_same_ && i < width; i++) {
+    is_schema_same_ = output_columns[i]->GetTableInd() == i;
+  }
+  // read the inputs in turns, the first one to end is the smaller
+  std::deque<Row> rows[2];
+  bool done[2]{false, false};
+  size_t size = 0;
+  RowId rid;
+  while (!done[0] && !done[1] && size <= memory_limit_) {
+    for (int side = 0; side < 2; side++) {
+      rows[side].emplace_back();
+      if (children_[side]->Next(&rows[side].back(), &rid)) {
+        size += RowSize(rows[side].back());
+      } else {
+        rows[side].pop_back();
+        done[side] = true;
+      }
+    }
+  }
+  if (!done[0] && !done[1]) {
+    PartitionInputs(rows);
+    LoadNextPartition();
+    return;
+  }
+  build_side_ = done[0] && (!done[1] || rows[0].size() <= rows[1].size()) ? 0 : 1;
+  build_rows_.swap(rows[build_side_]);
+  probe_rows_.swap(rows[1 - build_side_]);
+  BuildTable();
+}
+
+bool HashJoinExecutor::Next(Row *row, RowId *rid) {
+  std::string key;
+  while (true) {
+    while (match_ != match_end_) {
+      const Row *build_row = match_->second;
+      ++match_;
+      if (JoinRows(probe_row_, *build_row, row)) {
+        *rid = RowId();
+        return true;
+      }
+    }
+    if (!NextProbeRow(probe_row_)) {
+      return false;
+    }
+    if (MakeKey(probe_row_, 1 - build_side_, key)) {
+      std::tie(match_, match_end_) = hash_table_.equal_range(key);
+    }
+  }
+}
+
+bool HashJoinExecutor::MakeKey(const Row &row, int side, std::string &key) const {
+  const auto &expressions = side == 0 ? plan_->LeftJoinKeyExpressions() : plan_->RightJoinKeyExpressions();
+  key.clear();
+  for (const auto &expression : expressions) {
+    Field field = expression->Evaluate(&row);
+    if (field.IsNull()) {
+      return false;
+    }
+    // -0.0 and 0.0 are equal but not serialized the same
+    if (field.GetTypeId() == kTypeFloat && field.CompareEquals(Field(kTypeFloat, 0.0f)) == kTrue) {
+      Field zero(kTypeFloat, 0.0f);
+      field = zero;
+    }
+    // a char field is serialized with its length, so the encodings of two keys are equal only if all fields are
+    size_t offset = key.size();
+    key.resize(offset + field.GetSerializedSize());
+    field.SerializeTo(&key[offset]);
+  }
+  return true;
+}
+
+size_t HashJoinExecutor::RowSize(const Row &row) {
+  size_t size = sizeof(Row);
+  for (uint32_t i = 0; i < row.GetFieldCount(); i++) {
+    size += sizeof(Field) + row.GetField(i)->GetSerializedSize();
+  }
+  return size;
+}
+
+void HashJoinExecutor::BuildTable() {
+  hash_table_.clear();
+  hash_table_.reserve(build_rows_.size());
+  std::string key;
+  for (const auto &build_row : build_rows_) {
+    if (MakeKey(build_row, build_side_, key)) {
+      hash_table_.emplace(key, &build_row);
+    }
+  }
+  match_ = match_end_ = hash_table_.end();
+}
+
+void HashJoinExecutor::PartitionInputs(std::deque<Row> (&rows)[2]) {
+  partitioned_ = true;
+  partitions_.resize(HASH_JOIN_PARTITIONS);
+  std::string key;
+  auto add = [this, &key](const Row &row, int side) {
+    if (!MakeKey(row, side, key)) {
+      return;
+    }
+    Partition &partition = partitions_[std::hash<std::string>{}(key) % partitions_.size()];
+    if (partition.files_[side] == nullptr) {
+      partition.files_[side] = tmpfile();
+      if (partition.files_[side] == nullptr) {
+        LOG(ERROR) << "Failed to create a temporary file for a hash join partition.";
+        throw std::runtime_error("Failed to create a temporary file");
+      }
+    }
+    partition.sizes_[side] += WriteRow(partition.files_[side], row);
+  };
+  RowId rid;
+  for (int side = 0; side < 2; side++) {
+    for (const auto &row : rows[side]) {
+      add(row, side);
+    }
+    rows[side].clear();
+    Row row;
+    while (children_[side]->Next(&row, &rid)) {
+      add(row, side);
+    }
+  }
+}
+
+size_t HashJoinExecutor::WriteRow(FILE *file, const Row &row) {
+  // the size of the row, then a null flag and the serialized field for each field
+  buffer_.resize(sizeof(uint32_t));
+  for (uint32_t i = 0; i < row.GetFieldCount(); i++) {
+    const Field *field = row.GetField(i);
+    size_t offset = buffer_.size();
+    buffer_.resize(offset + 1 + field->GetSerializedSize());
+    buffer_[offset] = static_cast<char>(field->IsNull());
+    field->SerializeTo(&buffer_[offset + 1]);
+  }
+  uint32_t size = buffer_.size() - sizeof(uint32_t);
+  memcpy(buffer_.data(), &size, sizeof(uint32_t));
+  if (fwrite(buffer_.data(), buffer_.size(), 1, file) != 1) {
+    LOG(ERROR) << "Failed to write a hash join partition to a temporary file.";
+    throw std::runtime_error("Failed to write a temporary file");
+  }
+  return buffer_.size();
+}
+
+bool HashJoinExecutor::ReadRow(FILE *file, int side, Row &row) {
+  uint32_t size;
+  if (fread(&size, sizeof(uint32_t), 1, file) != 1) {
+    return false;
+  }
+  buffer_.resize(size);
+  if (size > 0 && fread(buffer_.data(), size, 1, file) != 1) {
+    LOG(ERROR) << "Failed to read a hash join partition from a temporary file.";
+    throw std::runtime_error("Failed to read a temporary file");
+  }
+  row.destroy();
+  const Schema *schema = children_[side]->GetOutputSchema();
+  auto &fields = row.GetFields();
+  char *buf = buffer_.data();
+  for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+    bool is_null = *buf++ != 0;
+    Field *field = nullptr;
+    buf += Field::DeserializeFrom(buf, schema->GetColumn(i)->GetType(), &field, is_null);
+    fields.push_back(field);
+  }
+  return true;
+}
+
+/*
+ * A partition with rows on one side only has nothing to join. Its files, like those of the partition just joined,
+ * are closed as the partitions are passed.
+ */
+bool HashJoinExecutor::LoadNextPartition() {
+  build_rows_.clear();
+  hash_table_.clear();
+  match_ = match_end_ = hash_table_.end();
+  probe_file_ = nullptr;
+  for (; next_partition_ < partitions_.size(); next_partition_++) {
+    if (next_partition_ > 0) {
+      for (auto &file : partitions_[next_partition_ - 1].files_) {
+        if (file != nullptr) {
+          fclose(file);
+          file = nullptr;
+        }
+      }
+    }
+    Partition &partition = partitions_[next_partition_];
+    if (partition.files_[0] == nullptr || partition.files_[1] == nullptr) {
+      continue;
+    }
+    build_side_ = partition.sizes_[0] <= partition.sizes_[1] ? 0 : 1;
+    rewind(partition.files_[0]);
+    rewind(partition.files_[1]);
+    build_rows_.emplace_back();
+    while (ReadRow(partition.files_[build_side_], build_side_, build_rows_.back())) {
+      build_rows_.emplace_back();
+    }
+    build_rows_.pop_back();
+    BuildTable();
+    probe_file_ = partition.files_[1 - build_side_];
+    next_partition_++;
+    return true;
+  }
+  return false;
+}
+
+bool HashJoinExecutor::NextProbeRow(Row &row) {
+  if (!partitioned_) {
+    if (!probe_rows_.empty()) {
+      row = probe_rows_.front();
+      probe_rows_.pop_front();
+      return true;
+    }
+    RowId rid;
+    return children_[1 - build_side_]->Next(&row, &rid);
+  }
+  while (probe_file_ != nullptr) {
+    if (ReadRow(probe_file_, 1 - build_side_, row)) {
+      return true;
+    }
+    LoadNextPartition();
+  }
+  return false;
+}
+
+bool HashJoinExecutor::JoinRows(const Row &probe_row, const Row &build_row, Row *row) const {
+  const Row &left = build_side_ == 0 ? build_row : probe_row;
+  const Row &right = build_side_ == 0 ? probe_row : build_row;
+  Row joined;
+  auto &fields = joined.GetFields();
+  fields.reserve(left.GetFieldCount() + right.GetFieldCount());
+  for (uint32_t i = 0; i < left.GetFieldCount(); i++) {
+    fields.push_back(new Field(*left.GetField(i)));
+  }
+  for (uint32_t i = 0; i < right.GetFieldCount(); i++) {
+    fields.push_back(new Field(*right.GetField(i)));
+  }
+  auto predicate = plan_->GetPredicate();
+  if (predicate != nullptr && !predicate->Evaluate(&joined).CompareEquals(Field(kTypeInt, 1))) {
+    return false;
+  }
+  row->destroy();
+  if (is_schema_same_) {
+    row->GetFields().swap(fields);
+  } else {
+    for (const auto column : plan_->OutputSchema()->GetColumns()) {
+      row->GetFields().push_back(new Field(*joined.GetField(column->GetTableInd())));
+    }
+  }
+  return true;
+}
@@ -0,0 +1,67 @@
+#include "executor/executors/index_only_scan_executor.h"
+
+IndexOnlyScanExecutor::IndexOnlyScanExecutor(ExecuteContext *exec_ctx, const IndexOnlyScanPlanNode *plan)
+    : IndexScanExecutor(exec_ctx, plan) {}
+
+void IndexOnlyScanExecutor::Init() {
+  IndexScanExecutor::Init();
+  const auto &key_columns = index_info_->GetIndexKeySchema()->GetColumns();
+  auto key_index = [&key_columns](uint32_t table_ind) {
+    for (uint32_t i = 0; i < key_columns.size(); i++) {
+      if (key_columns[i]->GetTableInd() == table_ind) {
+        return static_cast<int>(i);
+      }
+    }
+    return -1;
+  };
+  table_keys_.clear();
+  for (const auto column : table_info_->GetSchema()->GetColumns()) {
+    table_keys_.push_back(key_index(column->GetTableInd()));
+  }
+  output_keys_.clear();
+  for (const auto column : plan_->OutputSchema()->GetColumns()) {
+    int index = key_index(column->GetTableInd());
+    ASSERT(index >= 0, "Output column is not in the index key.");
+    output_keys_.push_back(index);
+  }
+}
+
+/*
+ * The predicate reads its columns by their index in the table, so when it must be evaluated the key fields are placed
+ * in a row with the table layout, the columns outside of the key left null. The planner made sure the predicate does
+ * not read them.
+ */
+bool IndexOnlyScanExecutor::Next(Row *row, RowId *rid) {
+  auto predicate = plan_->GetCompiledPredicate();
+  auto table_schema = table_info_->GetSchema();
+  RowId row_id;
+  while (true) {
+    Row key;
+    if (!scan_->Next(row_id, key)) {
+      return false;
+    }
+    if (need_filter_) {
+      std::vector<Field> table_fields;
+      table_fields.reserve(table_schema->GetColumnCount());
+      for (uint32_t i = 0; i < table_keys_.size(); i++) {
+        if (table_keys_[i] >= 0) {
+          table_fields.emplace_back(*key.GetField(table_keys_[i]));
+        } else {
+          table_fields.emplace_back(table_schema->GetColumn(i)->GetType());
+        }
+      }
+      Row table_row(table_fields);
+      if (!predicate->Matches(table_row)) {
+        continue;
+      }
+    }
+    std::vector<Field> output_fields;
+    output_fields.reserve(output_keys_.size());
+    for (auto key_index : output_keys_) {
+      output_fields.emplace_back(*key.GetField(key_index));
+    }
+    *row = Row(output_fields);
+    *rid = row_id;
+    return true;
+  }
+}
@@ -1,18 +1,73 @@
 #include "executor/executors/index_scan_executor.h"
 
-class RowidCompare {
- public:
-  bool operator()(RowId rid1, RowId rid2) { return rid1.Get() < rid2.Get(); }
-};
-
 IndexScanExecutor::IndexScanExecutor(ExecuteContext *exec_ctx, const IndexScanPlanNode *plan)
     : AbstractExecutor(exec_ctx), plan_(plan) {}
 
+/*
+ * Only one index is scanned, the one with the most selective range: the longest prefix of key columns pinned by
+ * equalities, then a range bounded on both sides of the next key column, then on one side. Rows are fetched as the
+ * scan goes, and the predicate is evaluated on them unless the range covers it exactly.
+ */
 void IndexScanExecutor::Init() {
   exec_ctx_->GetCatalog()->GetTable(plan_->GetTableName(), table_info_);
-  auto first_row = table_info_->GetTableHeap()->Begin(nullptr);
-  result_ = IndexScan(plan_->GetPredicate());
   is_schema_same_ = SchemaEqual(table_info_->GetSchema(), plan_->OutputSchema());
+  std::vector<KeyRange> ranges(plan_->indexes_.size());
+  for (size_t i = 0; i < ranges.size(); i++) {
+    ranges[i].index_ = plan_->indexes_[i];
+    ranges[i].columns_.resize(plan_->indexes_[i]->GetIndexKeySchema()->GetColumnCount());
+  }
+  size_t comparisons = 0;
+  CollectRanges(plan_->GetPredicate(), ranges, comparisons);
+  auto rank = [](const KeyRange &range) {
+    size_t rank = 3 * range.prefix_;
+    if (range.prefix_ < range.columns_.size()) {
+      rank += static_cast<size_t>(range.columns_[range.prefix_].low_ != nullptr) +
+              static_cast<size_t>(range.columns_[range.prefix_].high_ != nullptr);
+    }
+    return rank;
+  };
+  KeyRange *best = &ranges[0];
+  for (auto &range : ranges) {
+    while (range.prefix_ < range.columns_.size() && range.columns_[range.prefix_].IsPoint()) {
+      range.prefix_++;
+    }
+    if (rank(range) > rank(*best)) {
+      best = &range;
+    }
+  }
+  // the bounds are the values of the point columns, followed by the bounds of the next column if it has any
+  std::vector<Field> low_fields, high_fields;
+  low_fields.reserve(best->columns_.size());
+  high_fields.reserve(best->columns_.size());
+  bool low_inclusive = true, high_inclusive = true;
+  size_t folded = 0;
+  for (size_t i = 0; i < best->columns_.size() && i <= best->prefix_; i++) {
+    const ColumnRange &column = best->columns_[i];
+    if (column.low_ != nullptr) {
+      low_fields.emplace_back(*column.low_);
+      low_inclusive = column.low_inclusive_;
+    } else if (column.high_ != nullptr) {
+      // NULL keys sort first and never meet the bound, start right after them
+      low_fields.emplace_back(best->index_->GetIndexKeySchema()->GetColumn(i)->GetType());
+      low_inclusive = false;
+    }
+    if (column.high_ != nullptr) {
+      high_fields.emplace_back(*column.high_);
+      high_inclusive = column.high_inclusive_;
+    }
+    folded += column.folded_;
+  }
+  need_filter_ = folded != comparisons;
+  std::unique_ptr<Row> low, high;
+  if (!low_fields.empty()) {
+    low = std::make_unique<Row>(low_fields);
+  }
+  if (!high_fields.empty()) {
+    high = std::make_unique<Row>(high_fields);
+  }
+  index_info_ = best->index_;
+  scan_ = best->index_->GetIndex()->ScanRange(low.get(), low_inclusive, high.get(), high_inclusive,
+                                              exec_ctx_->GetTransaction());
 }
 
 bool IndexScanExecutor::SchemaEqual(const Schema *table_schema, const Schema *output_schema) {
@@ -44,66 +99,114 @@ void IndexScanExecutor::TupleTransfer(const Schema *table_schema, const Schema *
   *output_row = Row(dest_row);
 }
 
-vector<RowId> IndexScanExecutor::IndexScan(AbstractExpressionRef predicate) {
-  switch (predicate->GetType()) {
-    case ExpressionType::LogicExpression: {
-      vector<RowId> lhs = IndexScan(predicate->GetChildAt(0));
-      vector<RowId> rhs = IndexScan(predicate->GetChildAt(1));
-      // The function cannot differentiate between the case where the number of rows that
-      // meet the criteria in the indexed column is zero and the case where the column is
-      // not indexed. Writing it this way will ignore the filtering effect brought about
-      // by having zero rows that meet the criteria in the indexed column.
-      if (plan_->need_filter_) {
-        if (lhs.empty()) return rhs;
-        if (rhs.empty()) return lhs;
-      }
-      sort(lhs.begin(), lhs.end(), RowidCompare());
-      sort(rhs.begin(), rhs.end(), RowidCompare());
-      vector<RowId> result;
-      set_intersection(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), back_inserter(result), RowidCompare());
-      return result;
+void IndexScanExecutor::CollectRanges(const AbstractExpressionRef &predicate, std::vector<KeyRange> &ranges,
+                                      size_t &comparisons) {
+  if (predicate->GetType() == ExpressionType::LogicExpression) {
+    for (const auto &child : predicate->GetChildren()) {
+      CollectRanges(child, ranges, comparisons);
     }
-    case ExpressionType::ComparisonExpression: {
-      std::vector<RowId> ret;
-      std::vector<Field> fields{predicate->GetChildAt(1)->Evaluate(nullptr)};
-      Row key(fields);
-      for (auto index : plan_->indexes_) {
-        uint32_t col_idx = dynamic_pointer_cast<ColumnValueExpression>(predicate->GetChildAt(0))->GetColIdx();
-        if (col_idx == index->GetIndexKeySchema()->GetColumn(0)->GetTableInd()) {
-          index->GetIndex()->ScanKey(key, ret, nullptr,
-                                     dynamic_pointer_cast<ComparisonExpression>(predicate)->GetComparisonType());
-          break;
-        }
+    return;
+  }
+  if (predicate->GetType() != ExpressionType::ComparisonExpression) {
+    return;
+  }
+  comparisons++;
+  auto column = dynamic_pointer_cast<ColumnValueExpression>(predicate->GetChildAt(0));
+  if (column == nullptr || predicate->GetChildAt(1)->GetType() != ExpressionType::ConstantExpression) {
+    return;
+  }
+  string op = dynamic_pointer_cast<ComparisonExpression>(predicate)->GetComparisonType();
+  Field value = predicate->GetChildAt(1)->Evaluate(nullptr);
+  // nothing equals NULL, and a key is only encoded from a field of its own type
+  if (value.IsNull() || value.GetTypeId() != column->GetReturnType()) {
+    return;
+  }
+  bool lower = op == ">" || op == ">=" || op == "=";
+  bool upper = op == "<" || op == "<=" || op == "=";
+  bool inclusive = op == ">=" || op == "<=" || op == "=";
+  if (!lower && !upper) {
+    return;
+  }
+  for (auto &range : ranges) {
+    for (size_t i = 0; i < range.columns_.size(); i++) {
+      if (range.index_->GetIndexKeySchema()->GetColumn(i)->GetTableInd() != column->GetColIdx()) {
+        continue;
       }
-      return ret;
+      ColumnRange &bounds = range.columns_[i];
+      if (lower && (bounds.low_ == nullptr || value.CompareGreaterThan(*bounds.low_) == kTrue ||
+                    (value.CompareEquals(*bounds.low_) == kTrue && !inclusive))) {
+        bounds.low_ = std::make_unique<Field>(value);
+        bounds.low_inclusive_ = inclusive;
+      }
+      if (upper && (bounds.high_ == nullptr || value.CompareLessThan(*bounds.high_) == kTrue ||
+                    (value.CompareEquals(*bounds.high_) == kTrue && !inclusive))) {
+        bounds.high_ = std::make_unique<Field>(value);
+        bounds.high_inclusive_ = inclusive;
+      }
+      bounds.folded_++;
     }
-    default:
-      break;
   }
 }
 
 bool IndexScanExecutor::Next(Row *row, RowId *rid) {
-  auto predicate = plan_->GetPredicate();
+  auto predicate = plan_->GetCompiledPredicate();
   auto table_schema = table_info_->GetSchema();
-  while (cursor_ < result_.size()) {
-    auto p_row = new Row(result_[cursor_]);
-    table_info_->GetTableHeap()->GetTuple(p_row, nullptr);
-    if (plan_->need_filter_) {
-      if (!predicate->Evaluate(p_row).CompareEquals(Field(kTypeInt, 1))) {
-        cursor_++;
-        delete p_row;
-        continue;
-      }
+  RowId row_id;
+  while (scan_->Next(row_id)) {
+    Row table_row(row_id);
+    table_info_->GetTableHeap()->GetTuple(&table_row, exec_ctx_->GetTransaction());
+    if (need_filter_ && !predicate->Matches(table_row)) {
+      continue;
     }
-    *rid = result_[cursor_];
+    *rid = row_id;
     if (!is_schema_same_) {
-      TupleTransfer(table_schema, plan_->OutputSchema(), p_row, row);
+      TupleTransfer(table_schema, plan_->OutputSchema(), &table_row, row);
     } else {
-      *row = *p_row;
+      *row = table_row;
     }
-    delete p_row;
-    cursor_++;
     return true;
   }
   return false;
 }
+
+bool IndexScanExecutor::NextBatch(RowBatch *batch) {
+  auto predicate = plan_->GetCompiledPredicate();
+  if (input_.Capacity() != batch->Capacity()) {
+    input_ = RowBatch(batch->Capacity());
+  }
+  RowBatch *input = is_schema_same_ ? batch : &input_;
+  batch->Clear();
+  RowId row_id;
+  while (batch->GetSelection().empty()) {
+    input->Clear();
+    while (!input->IsFull() && scan_->Next(row_id)) {
+      Row &table_row = input->Append();
+      table_row.destroy();
+      table_row.SetRowId(row_id);
+      if (!table_info_->GetTableHeap()->GetTuple(&table_row, exec_ctx_->GetTransaction())) {
+        input->PopBack();
+      }
+    }
+    if (input->Size() == 0) {
+      return false;
+    }
+    input->SelectAll();
+    if (need_filter_) {
+      predicate->Select(input->GetRows(), input->GetSelection());
+    }
+    if (is_schema_same_) {
+      continue;
+    }
+    for (auto idx : input->GetSelection()) {
+      const Row &table_row = input->GetRow(idx);
+      Row &row = batch->Append();
+      row.destroy();
+      for (const auto column : plan_->OutputSchema()->GetColumns()) {
+        row.GetFields().push_back(new Field(*table_row.GetField(column->GetTableInd())));
+      }
+      row.SetRowId(table_row.GetRowId());
+    }
+    batch->SelectAll();
+  }
+  return true;
+}
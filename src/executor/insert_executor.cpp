@@ -16,27 +16,44 @@ void InsertExecutor::Init() {
 }
 
 bool InsertExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
-    Row insert_row;
-    RowId insert_rid;
-    if (child_executor_->Next(&insert_row, &insert_rid)) {
-        for (auto info: index_info_) {
-            Row key_row;
-            insert_row.GetKeyFromRow(table_info_->GetSchema(), info->GetIndexKeySchema(), key_row);
-            std::vector<RowId> result;
-            if (!key_row.GetFields().empty() &&
-                info->GetIndex()->ScanKey(key_row, result, exec_ctx_->GetTransaction()) == DB_SUCCESS) {
-                std::cout << "key already exists" << std::endl;
-                return false;
-            }
-        }
-        if (table_info_->GetTableHeap()->InsertTuple(insert_row, exec_ctx_->GetTransaction())) {
-            Row key_row;
-            for (auto info: index_info_) {  // 更新索引
-                insert_row.GetKeyFromRow(schema_, info->GetIndexKeySchema(), key_row);
-                info->GetIndex()->InsertEntry(key_row, insert_row.GetRowId(), exec_ctx_->GetTransaction());
-            }
-            return true;
-        }
+  Row insert_row;
+  RowId insert_rid;
+  return child_executor_->Next(&insert_row, &insert_rid) && InsertRow(insert_row);
+}
+
+bool InsertExecutor::NextBatch(RowBatch *batch) {
+  if (done_ || !child_executor_->NextBatch(batch)) {
+    return false;
+  }
+  auto &selection = batch->GetSelection();
+  for (size_t i = 0; i < selection.size(); i++) {
+    if (!InsertRow(batch->GetRow(selection[i]))) {
+      selection.resize(i);
+      done_ = true;
+      break;
+    }
   }
-  return false;
-}
\ No newline at end of file
+  return !selection.empty();
+}
+
+bool InsertExecutor::InsertRow(Row &row) {
+  for (auto info : index_info_) {
+    Row key_row;
+    row.GetKeyFromRow(table_info_->GetSchema(), info->GetIndexKeySchema(), key_row);
+    std::vector<RowId> result;
+    if (info->GetIndex()->IsUnique() && !key_row.GetFields().empty() &&
+        info->GetIndex()->ScanKey(key_row, result, exec_ctx_->GetTransaction()) == DB_SUCCESS) {
+      std::cout << "key already exists" << std::endl;
+      return false;
+    }
+  }
+  if (!table_info_->GetTableHeap()->InsertTuple(row, exec_ctx_->GetTransaction(), exec_ctx_->GetAccessStrategy())) {
+    return false;
+  }
+  Row key_row;
+  for (auto info : index_info_) {  // 更新索引
+    row.GetKeyFromRow(schema_, info->GetIndexKeySchema(), key_row);
+    info->GetIndex()->InsertEntry(key_row, row.GetRowId(), exec_ctx_->GetTransaction());
+  }
+  return true;
+}
@@ -0,0 +1,84 @@
+#include "executor/executors/nested_index_join_executor.h"
+
+#include <vector>
+
+NestedIndexJoinExecutor::NestedIndexJoinExecutor(ExecuteContext *exec_ctx, const NestedIndexJoinPlanNode *plan,
+                                                 std::unique_ptr<AbstractExecutor> &&child_executor)
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+
+void NestedIndexJoinExecutor::Init() {
+  child_executor_->Init();
+  exec_ctx_->GetCatalog()->GetTable(plan_->GetInnerTableName(), inner_table_);
+  const auto &output_columns = plan_->OutputSchema()->GetColumns();
+  size_t width = child_executor_->GetOutputSchema()->GetColumnCount() + inner_table_->GetSchema()->GetColumnCount();
+  is_schema_same_ = output_columns.size() == width;
+  for (size_t i = 0; is_schema_same_ && i < width; i++) {
+    is_schema_same_ = output_columns[i]->GetTableInd() == i;
+  }
+  scan_ = nullptr;
+}
+
+/*
+ * An outer value longer than its inner key column, e.g. of a char(20) column joined to a char(10) one, cannot equal
+ * any inner value, so the row is skipped without searching the index.
+ */
+void NestedIndexJoinExecutor::LookUp() {
+  auto key_schema = plan_->GetIndex()->GetIndexKeySchema();
+  std::vector<Field> key_fields;
+  key_fields.reserve(plan_->KeyExpressions().size());
+  for (const auto &expression : plan_->KeyExpressions()) {
+    key_fields.emplace_back(expression->Evaluate(&outer_row_));
+    const Field &value = key_fields.back();
+    if (value.IsNull()) {
+      return;
+    }
+    const Column *key_column = key_schema->GetColumn(key_fields.size() - 1);
+    if (key_column->GetType() == TypeId::kTypeChar && value.GetLength() > key_column->GetLength()) {
+      return;
+    }
+  }
+  Row key(key_fields);
+  scan_ = plan_->GetIndex()->GetIndex()->ScanRange(&key, true, &key, true, exec_ctx_->GetTransaction());
+}
+
+bool NestedIndexJoinExecutor::Next(Row *row, RowId *rid) {
+  auto predicate = plan_->GetPredicate();
+  RowId inner_rid;
+  while (true) {
+    if (scan_ == nullptr || !scan_->Next(inner_rid)) {
+      scan_ = nullptr;
+      RowId outer_rid;
+      if (!child_executor_->Next(&outer_row_, &outer_rid)) {
+        return false;
+      }
+      LookUp();
+      continue;
+    }
+    Row inner_row(inner_rid);
+    if (!inner_table_->GetTableHeap()->GetTuple(&inner_row, exec_ctx_->GetTransaction())) {
+      continue;
+    }
+    Row joined;
+    auto &fields = joined.GetFields();
+    fields.reserve(outer_row_.GetFieldCount() + inner_row.GetFieldCount());
+    for (uint32_t i = 0; i < outer_row_.GetFieldCount(); i++) {
+      fields.push_back(new Field(*outer_row_.GetField(i)));
+    }
+    for (uint32_t i = 0; i < inner_row.GetFieldCount(); i++) {
+      fields.push_back(new Field(*inner_row.GetField(i)));
+    }
+    if (predicate != nullptr && !predicate->Evaluate(&joined).CompareEquals(Field(kTypeInt, 1))) {
+      continue;
+    }
+    row->destroy();
+    if (is_schema_same_) {
+      row->GetFields().swap(fields);
+    } else {
+      for (const auto column : plan_->OutputSchema()->GetColumns()) {
+        row->GetFields().push_back(new Field(*joined.GetField(column->GetTableInd())));
+      }
+    }
+    *rid = RowId();
+    return true;
+  }
+}
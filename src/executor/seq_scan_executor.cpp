@@ -3,12 +3,16 @@
 //
 #include "executor/executors/seq_scan_executor.h"
 
+#include <stdexcept>
+
 SeqScanExecutor::SeqScanExecutor(ExecuteContext *exec_ctx, const SeqScanPlanNode *plan)
     : AbstractExecutor(exec_ctx),
       plan_(plan),
       iterator_(nullptr, RowId(INVALID_PAGE_ID, 0), nullptr),
       is_schema_same_(false) {}
 
+SeqScanExecutor::~SeqScanExecutor() { StopWorkers(); }
+
 bool SeqScanExecutor::SchemaEqual(const Schema *table_schema, const Schema *output_schema) {
   auto table_columns = table_schema->GetColumns();
   auto output_columns = output_schema->GetColumns();
@@ -39,20 +43,35 @@ void SeqScanExecutor::TupleTransfer(const Schema *table_schema, const Schema *ou
 }
 
 void SeqScanExecutor::Init() {
+  StopWorkers();
   exec_ctx_->GetCatalog()->GetTable(plan_->GetTableName(), table_info_);
   auto first_row = table_info_->GetTableHeap()->Begin(nullptr);
-  iterator_ = (table_info_->GetTableHeap()->Begin(exec_ctx_->GetTransaction()));
+  iterator_ = (table_info_->GetTableHeap()->Begin(exec_ctx_->GetTransaction(), &strategy_));
   schema_ = plan_->OutputSchema();
   is_schema_same_ = SchemaEqual(table_info_->GetSchema(), schema_);
+  StartWorkers();
 }
 
 bool SeqScanExecutor::Next(Row *row, RowId *rid) {
-  auto predicate = plan_->GetPredicate();
+  if (!workers_.empty()) {
+    while (current_.empty()) {
+      if (!NextMorsel()) {
+        return false;
+      }
+    }
+    Row &next = current_.front();
+    row->GetFields().swap(next.GetFields());
+    row->SetRowId(next.GetRowId());
+    *rid = next.GetRowId();
+    current_.pop_front();
+    return true;
+  }
+  auto predicate = plan_->GetCompiledPredicate();
   auto table_schema = table_info_->GetSchema();
   while (iterator_ != table_info_->GetTableHeap()->End()) {
     auto p_row = &(*iterator_);
     if (predicate != nullptr) {
-      if (!predicate->Evaluate(p_row).CompareEquals(Field(kTypeInt, 1))) {
+      if (!predicate->Matches(*p_row)) {
         iterator_++;
         continue;
       }
@@ -68,3 +87,248 @@ bool SeqScanExecutor::Next(Row *row, RowId *rid) {
   }
   return false;
 }
+
+/**
+ * Rows are read a page at a time and filtered as a whole batch. Only the rows selected are projected, and batches
+ * where the predicate selects nothing are skipped.
+ */
+bool SeqScanExecutor::NextBatch(RowBatch *batch) {
+  if (!workers_.empty()) {
+    batch->Clear();
+    while (!batch->IsFull()) {
+      if (current_.empty() && !NextMorsel()) {
+        break;
+      }
+      while (!batch->IsFull() && !current_.empty()) {
+        Row &row = batch->Append();
+        row.destroy();
+        row.GetFields().swap(current_.front().GetFields());
+        row.SetRowId(current_.front().GetRowId());
+        current_.pop_front();
+      }
+    }
+    batch->SelectAll();
+    return batch->Size() > 0;
+  }
+  auto predicate = plan_->GetCompiledPredicate();
+  auto table_end = table_info_->GetTableHeap()->End();
+  if (input_.Capacity() != batch->Capacity()) {
+    input_ = RowBatch(batch->Capacity());
+  }
+  RowBatch *input = is_schema_same_ ? batch : &input_;
+  batch->Clear();
+  while (batch->GetSelection().empty()) {
+    input->Clear();
+    while (!input->IsFull() && iterator_ != table_end) {
+      size_t read = iterator_.ReadRows(input->GetRows(), input->Size());
+      if (read == 0) {
+        break;
+      }
+      input->SetSize(input->Size() + read);
+    }
+    if (input->Size() == 0) {
+      return false;
+    }
+    input->SelectAll();
+    if (predicate != nullptr) {
+      predicate->Select(input->GetRows(), input->GetSelection());
+    }
+    if (is_schema_same_) {
+      continue;
+    }
+    for (auto idx : input->GetSelection()) {
+      const Row &table_row = input->GetRow(idx);
+      Row &row = batch->Append();
+      row.destroy();
+      for (const auto column : schema_->GetColumns()) {
+        row.GetFields().push_back(new Field(*table_row.GetField(column->GetTableInd())));
+      }
+      row.SetRowId(table_row.GetRowId());
+    }
+    batch->SelectAll();
+  }
+  return true;
+}
+
+/**
+ * The table heap has no page directory, so the workers share a cursor over its page chain: a worker claims a morsel
+ * by fetching its pages and moving the cursor past them, then scans them without holding the cursor. Morsels are
+ * numbered in page order and handed out in that order, so the rows come out exactly as a serial scan returns them.
+ *
+ * Every worker keeps a morsel pinned, so there are only as many workers as fit in half of the buffer pool.
+ */
+void SeqScanExecutor::StartWorkers() {
+  auto table_heap = table_info_->GetTableHeap();
+  auto bpm = exec_ctx_->GetBufferPoolManager();
+  next_page_id_ = table_heap->GetFirstPageId();
+  morsels_claimed_ = 0;
+  morsels_returned_ = 0;
+  pages_until_read_ahead_ = 0;
+  cursor_done_ = false;
+  error_.clear();
+  stop_ = false;
+  size_t parallelism =
+      std::min<size_t>(plan_->GetParallelism(), bpm->GetPoolSize() / (2 * PARALLEL_SCAN_MORSEL_PAGES));
+  if (parallelism <= 1 || next_page_id_ == INVALID_PAGE_ID) {
+    return;
+  }
+  // a table of a single page is not worth the threads
+  auto page = reinterpret_cast<TablePage *>(bpm->FetchPage(next_page_id_, &strategy_));
+  if (page == nullptr) {
+    return;
+  }
+  page->RLatch();
+  bool single_page = page->GetNextPageId() == INVALID_PAGE_ID;
+  page->RUnlatch();
+  bpm->UnpinPage(page->GetTablePageId(), false);
+  if (single_page) {
+    return;
+  }
+  window_ = 2 * parallelism;
+  for (size_t i = 0; i < parallelism; i++) {
+    workers_.emplace_back(&SeqScanExecutor::ScanMorsels, this);
+  }
+}
+
+void SeqScanExecutor::StopWorkers() {
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    stop_ = true;
+  }
+  window_open_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+  done_.clear();
+  current_.clear();
+}
+
+/**
+ * The next morsel is only known once the pages before it are fetched, so the chain is walked by one worker at a time
+ * under cursor_latch_, helped by read-ahead of the whole window. latch_ is only taken to number the morsel, so the
+ * reads never hold up the hand-out of the rows.
+ */
+void SeqScanExecutor::ScanMorsels() {
+  auto bpm = exec_ctx_->GetBufferPoolManager();
+  std::vector<TablePage *> pages;
+  while (true) {
+    size_t morsel;
+    std::unique_lock<std::mutex> cursor(cursor_latch_);
+    {
+      std::unique_lock<std::mutex> lock(latch_);
+      window_open_.wait(lock, [this] { return stop_ || morsels_claimed_ < morsels_returned_ + window_; });
+      if (stop_ || cursor_done_) {
+        return;
+      }
+      morsel = morsels_claimed_++;
+    }
+    while (pages.size() < static_cast<size_t>(PARALLEL_SCAN_MORSEL_PAGES) && next_page_id_ != INVALID_PAGE_ID) {
+      auto page = reinterpret_cast<TablePage *>(bpm->FetchPage(next_page_id_, &strategy_));
+      if (page == nullptr) {
+        for (auto fetched : pages) {
+          bpm->UnpinPage(fetched->GetTablePageId(), false);
+        }
+        {
+          std::lock_guard<std::mutex> guard(latch_);
+          error_ = "Failed to fetch page " + std::to_string(next_page_id_) + " of table " + plan_->GetTableName() +
+                   ", the buffer pool is full";
+          cursor_done_ = true;
+        }
+        morsel_done_.notify_all();
+        return;
+      }
+      page->RLatch();
+      next_page_id_ = page->GetNextPageId();
+      page->RUnlatch();
+      pages.push_back(page);
+      // one read-ahead of the whole window every half window, as the workers consume pages much faster than one
+      if (pages_until_read_ahead_ > 0) {
+        pages_until_read_ahead_--;
+      } else if (next_page_id_ != INVALID_PAGE_ID) {
+        bpm->PrefetchPage(next_page_id_, TABLE_READ_AHEAD_MAX, TablePage::NextPageIdOf);
+        pages_until_read_ahead_ = TABLE_READ_AHEAD_MAX / 2;
+      }
+    }
+    if (next_page_id_ == INVALID_PAGE_ID) {
+      std::lock_guard<std::mutex> guard(latch_);
+      cursor_done_ = true;
+    }
+    cursor.unlock();
+    std::deque<Row> rows;
+    for (auto page : pages) {
+      ScanPage(page, rows);
+      bpm->UnpinPage(page->GetTablePageId(), false);
+    }
+    pages.clear();
+    {
+      std::lock_guard<std::mutex> guard(latch_);
+      done_[morsel].swap(rows);
+    }
+    morsel_done_.notify_all();
+  }
+}
+
+void SeqScanExecutor::ScanPage(TablePage *page, std::deque<Row> &rows) {
+  auto table_schema = table_info_->GetSchema();
+  size_t begin = rows.size();
+  RowId rid;
+  page->RLatch();
+  bool has_next = page->GetFirstTupleRid(&rid);
+  while (has_next) {
+    rows.emplace_back(rid);
+    if (!page->GetTuple(&rows.back(), table_schema, nullptr, nullptr)) {
+      rows.pop_back();
+    }
+    RowId next_rid;
+    has_next = page->GetNextTupleRid(rid, &next_rid);
+    rid = next_rid;
+  }
+  page->RUnlatch();
+  // filter and project without the page latch, moving the rows kept to the front
+  auto predicate = plan_->GetCompiledPredicate();
+  size_t end = begin;
+  for (size_t i = begin; i < rows.size(); i++) {
+    Row &row = rows[i];
+    if (predicate != nullptr && !predicate->Matches(row)) {
+      continue;
+    }
+    Row &dest = rows[end++];
+    if (!is_schema_same_) {
+      std::vector<Field *> fields;
+      fields.reserve(schema_->GetColumnCount());
+      for (const auto column : schema_->GetColumns()) {
+        fields.push_back(new Field(*row.GetField(column->GetTableInd())));
+      }
+      row.destroy();
+      row.GetFields().swap(fields);
+    }
+    if (&dest != &row) {
+      dest.destroy();
+      dest.GetFields().swap(row.GetFields());
+      dest.SetRowId(row.GetRowId());
+    }
+  }
+  rows.resize(end);
+}
+
+bool SeqScanExecutor::NextMorsel() {
+  std::unique_lock<std::mutex> lock(latch_);
+  morsel_done_.wait(lock, [this] {
+    return !error_.empty() || done_.count(morsels_returned_) > 0 ||
+           (cursor_done_ && morsels_returned_ == morsels_claimed_);
+  });
+  if (!error_.empty()) {
+    throw std::runtime_error(error_);
+  }
+  auto iter = done_.find(morsels_returned_);
+  if (iter == done_.end()) {
+    return false;
+  }
+  current_.swap(iter->second);
+  done_.erase(iter);
+  morsels_returned_++;
+  lock.unlock();
+  window_open_.notify_all();
+  return true;
+}
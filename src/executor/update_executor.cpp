@@ -18,22 +18,39 @@ void UpdateExecutor::Init() {
 bool UpdateExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
   Row src_row;
   RowId src_rid;
-  if (child_executor_->Next(&src_row, &src_rid)) {
-    Row dest_row = GenerateUpdatedTuple(src_row);
-    if (!table_info_->GetTableHeap()->UpdateTuple(dest_row, src_rid, txn_)) {
-      return false;
-    }
-    Row src_key_row;
-    Row dest_key_row;
-    for (auto info : index_info_) {  // 更新索引
-      src_row.GetKeyFromRow(table_info_->GetSchema(), info->GetIndexKeySchema(), src_key_row);
-      dest_row.GetKeyFromRow(table_info_->GetSchema(), info->GetIndexKeySchema(), dest_key_row);
-      info->GetIndex()->RemoveEntry(src_key_row, src_rid, txn_);
-      info->GetIndex()->InsertEntry(dest_key_row, src_rid, txn_);
+  return child_executor_->Next(&src_row, &src_rid) && UpdateRow(src_row, src_rid);
+}
+
+bool UpdateExecutor::NextBatch(RowBatch *batch) {
+  if (done_ || !child_executor_->NextBatch(batch)) {
+    return false;
+  }
+  auto &selection = batch->GetSelection();
+  for (size_t i = 0; i < selection.size(); i++) {
+    Row &src_row = batch->GetRow(selection[i]);
+    if (!UpdateRow(src_row, src_row.GetRowId())) {
+      selection.resize(i);
+      done_ = true;
+      break;
     }
-    return true;
   }
-  return false;
+  return !selection.empty();
+}
+
+bool UpdateExecutor::UpdateRow(Row &src_row, const RowId &src_rid) {
+  Row dest_row = GenerateUpdatedTuple(src_row);
+  if (!table_info_->GetTableHeap()->UpdateTuple(dest_row, src_rid, txn_)) {
+    return false;
+  }
+  Row src_key_row;
+  Row dest_key_row;
+  for (auto info : index_info_) {  // 更新索引
+    src_row.GetKeyFromRow(table_info_->GetSchema(), info->GetIndexKeySchema(), src_key_row);
+    dest_row.GetKeyFromRow(table_info_->GetSchema(), info->GetIndexKeySchema(), dest_key_row);
+    info->GetIndex()->RemoveEntry(src_key_row, src_rid, txn_);
+    info->GetIndex()->InsertEntry(dest_key_row, src_rid, txn_);
+  }
+  return true;
 }
 
 Row UpdateExecutor::GenerateUpdatedTuple(const Row &src_row) {
@@ -0,0 +1,51 @@
+#ifndef MINISQL_BUFFER_ACCESS_STRATEGY_H
+#define MINISQL_BUFFER_ACCESS_STRATEGY_H
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+
+using namespace std;
+
+/**
+ * BufferAccessStrategy is handed to the buffer pool by large sequential scans and bulk loads.
+ *
+ * Once such an access has read more than SCAN_RING_THRESHOLD percent of a buffer pool instance, the pages it reads are
+ * placed in a small ring of frames that is recycled in place, instead of evicting the hot pages of the shared pool.
+ * Each buffer pool instance keeps its own ring, and the ring only records page ids, so a strategy may outlive any of
+ * the pages it has read.
+ */
+class BufferAccessStrategy {
+  friend class BufferPoolManagerInstance;
+
+ public:
+  /**
+   * @param ring_size number of frames the access may use in each buffer pool instance once the ring is active
+   */
+  explicit BufferAccessStrategy(size_t ring_size = SCAN_RING_SIZE) : ring_size_(ring_size == 0 ? 1 : ring_size) {}
+
+ private:
+  struct Ring {
+    vector<page_id_t> pages_;  // pages read into the ring, INVALID_PAGE_ID for unused slots
+    size_t next_{0};           // slot recycled by the next read
+    size_t reads_{0};          // number of pages read through the strategy
+  };
+
+  /** @return the ring used by a buffer pool instance, created on first use */
+  Ring &GetRing(const void *instance) {
+    lock_guard<mutex> guard(latch_);
+    Ring &ring = rings_[instance];
+    if (ring.pages_.empty()) {
+      ring.pages_.assign(ring_size_, INVALID_PAGE_ID);
+    }
+    return ring;
+  }
+
+  size_t ring_size_;
+  unordered_map<const void *, Ring> rings_;  // one ring per buffer pool instance
+  mutex latch_;                              // protects rings_, each ring is protected by its instance
+};
+
+#endif  // MINISQL_BUFFER_ACCESS_STRATEGY_H
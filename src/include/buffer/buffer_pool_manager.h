@@ -5,54 +5,72 @@
 #include <mutex>
 #include <unordered_map>
 
-#include "buffer/lru_replacer.h"
+#include "buffer/buffer_access_strategy.h"
 #include "page/disk_file_meta_page.h"
 #include "page/page.h"
 #include "storage/disk_manager.h"
 
 using namespace std;
 
+/** Extracts the id of the page following a page in a page chain from the raw page data, INVALID_PAGE_ID at the end. */
+using NextPageFunc = page_id_t (*)(const char *data);
+
+/**
+ * BufferPoolManager is the interface shared by all buffer pool implementations. Storage and access methods only use
+ * this interface, so a single BufferPoolManagerInstance or a sharded ParallelBufferPoolManager can be plugged in.
+ */
 class BufferPoolManager {
  public:
-  explicit BufferPoolManager(size_t pool_size, DiskManager *disk_manager);
-
-  ~BufferPoolManager();
-
-  Page *FetchPage(page_id_t page_id);
-
-  bool UnpinPage(page_id_t page_id, bool is_dirty);
+  BufferPoolManager() = default;
 
-  bool FlushPage(page_id_t page_id);
+  virtual ~BufferPoolManager() = default;
 
-  Page *NewPage(page_id_t &page_id);
-
-  bool DeletePage(page_id_t page_id);
+  /**
+   * Fetch the requested page from the buffer pool and pin it.
+   * @param strategy access strategy of a large scan or bulk load, nullptr for regular accesses
+   * @return nullptr if the page is not resident and all frames are pinned
+   */
+  virtual Page *FetchPage(page_id_t page_id, BufferAccessStrategy *strategy = nullptr) = 0;
 
-  bool IsPageFree(page_id_t page_id);
+  /**
+   * Unpin the target page from the buffer pool.
+   * @param is_dirty true if the page should be marked as dirty
+   */
+  virtual bool UnpinPage(page_id_t page_id, bool is_dirty) = 0;
 
-  bool CheckAllUnpinned();
+  /**
+   * Write the target page back to disk.
+   */
+  virtual bool FlushPage(page_id_t page_id) = 0;
 
- private:
   /**
-   * Allocate new page (operations like create index/table) For now just keep an increasing counter
+   * Allocate a new page on disk and bring it into the buffer pool pinned.
+   * @param[out] page_id id of the allocated page
+   * @param strategy access strategy of a bulk load, nullptr for regular accesses
+   * @return nullptr if all frames are pinned
    */
-  page_id_t AllocatePage();
+  virtual Page *NewPage(page_id_t &page_id, BufferAccessStrategy *strategy = nullptr) = 0;
 
   /**
-   * Deallocate page (operations like drop index/table) Need bitmap in header page for tracking pages
+   * Delete a page from the buffer pool and release its disk storage.
    */
-  void DeallocatePage(page_id_t page_id);
+  virtual bool DeletePage(page_id_t page_id) = 0;
 
-  frame_id_t TryToFindFreePage();
+  virtual bool IsPageFree(page_id_t page_id) = 0;
 
- public:
-  size_t pool_size_;                                 // number of pages in buffer pool
-  Page *pages_;                                      // array of pages
-  DiskManager *disk_manager_;                        // pointer to the disk manager.
-  unordered_map<page_id_t, frame_id_t> page_table_;  // to keep track of pages
-  Replacer *replacer_;                               // to find an unpinned page for replacement
-  list<frame_id_t> free_list_;                       // to find a free page for replacement
-  recursive_mutex latch_;                            // to protect shared data structure
+  /** @return the number of pages that may be pinned at the same time */
+  virtual size_t GetPoolSize() = 0;
+
+  /**
+   * Hint that a page will be fetched soon. The page is read in the background and left unpinned in the buffer pool,
+   * so a later FetchPage does not wait for the disk. Hints may be dropped at any time.
+   * @param chain_length number of pages to read along the page chain, starting at page_id
+   * @param next_page used to find the next page of the chain, may be nullptr if chain_length is 1
+   */
+  virtual void PrefetchPage(page_id_t page_id, size_t chain_length = 1, NextPageFunc next_page = nullptr) {}
+
+  // Only used for debug
+  virtual bool CheckAllUnpinned() = 0;
 };
 
 #endif  // MINISQL_BUFFER_POOL_MANAGER_H
@@ -0,0 +1,170 @@
+#ifndef MINISQL_BUFFER_POOL_MANAGER_INSTANCE_H
+#define MINISQL_BUFFER_POOL_MANAGER_INSTANCE_H
+
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/lru_replacer.h"
+#include "page/disk_file_meta_page.h"
+#include "page/page.h"
+#include "storage/disk_manager.h"
+
+using namespace std;
+
+/**
+ * BufferPoolManagerInstance is a single buffer pool with its own frames, page table, free list, replacer and latch.
+ *
+ * Dirty frames are kept in a dirty list in the order they were first modified. A background flusher thread writes
+ * unpinned dirty pages back once the dirty ratio exceeds DIRTY_HIGH_WATERMARK (or every FLUSHER_INTERVAL_MS) until it
+ * drops to DIRTY_LOW_WATERMARK, so that eviction almost always finds a clean victim.
+ *
+ * Prefetch hints are queued and served by a background prefetcher thread, which reads pages without holding the latch.
+ */
+class BufferPoolManagerInstance : public BufferPoolManager {
+ public:
+  /**
+   * @param owner the buffer pool that prefetch requests following a page chain are forwarded to, this if nullptr
+   * @param replacer_type the replacement policy of the frames
+   */
+  explicit BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, BufferPoolManager *owner = nullptr,
+                                     ReplacerType replacer_type = DEFAULT_REPLACER);
+
+  ~BufferPoolManagerInstance() override;
+
+  Page *FetchPage(page_id_t page_id, BufferAccessStrategy *strategy = nullptr) override;
+
+  bool UnpinPage(page_id_t page_id, bool is_dirty) override;
+
+  bool FlushPage(page_id_t page_id) override;
+
+  Page *NewPage(page_id_t &page_id, BufferAccessStrategy *strategy = nullptr) override;
+
+  /**
+   * Bring a page that has already been allocated on disk into a zeroed, pinned frame.
+   * Used by ParallelBufferPoolManager, which allocates page ids itself to route them to the owning instance.
+   * @return nullptr if all frames are pinned
+   */
+  Page *NewPageWithId(page_id_t page_id, BufferAccessStrategy *strategy = nullptr);
+
+  bool DeletePage(page_id_t page_id) override;
+
+  bool IsPageFree(page_id_t page_id) override;
+
+  size_t GetPoolSize() override { return pool_size_; }
+
+  void PrefetchPage(page_id_t page_id, size_t chain_length = 1, NextPageFunc next_page = nullptr) override;
+
+  bool CheckAllUnpinned() override;
+
+  /**
+   * Stop the flusher and the prefetcher and drop any later prefetch hint. Called by the destructor, and by
+   * ParallelBufferPoolManager on all of its instances before deleting any, since a prefetcher forwards hints to the
+   * other instances.
+   */
+  void StopBackgroundThreads();
+
+ private:
+  /**
+   * Allocate new page (operations like create index/table) For now just keep an increasing counter
+   */
+  page_id_t AllocatePage();
+
+  /**
+   * Deallocate page (operations like drop index/table) Need bitmap in header page for tracking pages
+   */
+  void DeallocatePage(page_id_t page_id);
+
+  frame_id_t TryToFindFreePage();
+
+  /**
+   * Count a page read through strategy.
+   * @return the ring of strategy for this instance if the access has grown large enough to use it, nullptr otherwise
+   */
+  BufferAccessStrategy::Ring *CountStrategyRead(BufferAccessStrategy *strategy);
+
+  /**
+   * Evict the page held by the next slot of a ring, if it is still resident and unpinned.
+   * @return the frame of the evicted page, INVALID_FRAME_ID if the slot cannot be recycled
+   */
+  frame_id_t EvictRingSlot(BufferAccessStrategy::Ring *ring);
+
+  /** Record a page in the next slot of a ring. */
+  void AddToRing(BufferAccessStrategy::Ring *ring, page_id_t page_id);
+
+  /** Set the dirty flag of a frame and append it to the dirty list. */
+  void MarkDirty(frame_id_t frame_id);
+
+  /** Clear the dirty flag of a frame and remove it from the dirty list. */
+  void MarkClean(frame_id_t frame_id);
+
+  /**
+   * Write back up to max_pages (at most IO_BATCH_SIZE) of the oldest unpinned dirty pages in one batch. The caller holds
+   * latch_ through lock, which is released during the write.
+   * @return the number of pages written
+   */
+  size_t FlushDirtyPages(size_t max_pages, unique_lock<recursive_mutex> &lock);
+
+  /** Wait until a page that is being written back by the flusher has been written. */
+  void WaitForFlush(unique_lock<recursive_mutex> &lock, page_id_t page_id);
+
+  /** Body of the background flusher thread. */
+  void FlushWorker();
+
+  /** Body of the background prefetcher thread. */
+  void PrefetchWorker();
+
+  struct PrefetchRequest {
+    page_id_t page_id_;
+    size_t chain_length_;
+    NextPageFunc next_page_;
+  };
+
+  /**
+   * Move a prefetch request past the pages of its chain that are in this instance, the caller holds latch_.
+   * @return true if the request moved, its chain_length_ is 0 once the chain is done
+   */
+  bool WalkResidentChain(PrefetchRequest &request);
+
+  /**
+   * Put a prefetched page into an unpinned frame, unless it is resident already. The caller holds latch_.
+   * @return false if no frame could be freed
+   */
+  bool InstallPrefetchedPage(page_id_t page_id, const char *data);
+
+ public:
+  size_t pool_size_;                                 // number of pages in buffer pool
+  Page *pages_;                                      // array of pages
+  DiskManager *disk_manager_;                        // pointer to the disk manager.
+  unordered_map<page_id_t, frame_id_t> page_table_;  // to keep track of pages
+  Replacer *replacer_;                               // to find an unpinned page for replacement
+  list<frame_id_t> free_list_;                       // to find a free page for replacement
+  recursive_mutex latch_;                            // to protect shared data structure
+
+ private:
+  list<frame_id_t> dirty_list_;                      // dirty frames, oldest first
+  vector<list<frame_id_t>::iterator> dirty_pos_;     // position of each frame in dirty_list_, end() if clean
+  size_t dirty_high_;                                // dirty frame count that wakes the flusher
+  size_t dirty_low_;                                 // dirty frame count the flusher stops at
+  condition_variable_any flusher_cv_;                // wakes the flusher, waited on with latch_
+  vector<char> flush_buffer_;                        // copies of the pages written by the flusher
+  vector<bool> flushing_;                            // true if the frame is pinned by a write of the flusher
+  condition_variable_any flush_cv_;                  // signaled when a flusher batch is written, waited on with latch_
+  thread flusher_;                                   // background flusher thread
+  BufferPoolManager *owner_;                         // where prefetch requests along a page chain are forwarded
+  deque<PrefetchRequest> prefetch_queue_;            // pending prefetch requests
+  condition_variable_any prefetch_cv_;               // wakes the prefetcher, waited on with latch_
+  vector<bool> prefetched_;                          // true if the frame was prefetched and not fetched since
+  uint64_t write_epoch_{0};                          // bumped on every page write or delete, detects stale reads
+  thread prefetcher_;                                // background prefetcher thread
+  bool shutdown_{false};                             // set by the destructor to stop the background threads
+};
+
+#endif  // MINISQL_BUFFER_POOL_MANAGER_INSTANCE_H
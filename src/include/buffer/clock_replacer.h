@@ -15,7 +15,8 @@
 using namespace std;
 
 /**
- * CLOCKReplacer implements the clock replacement.
+ * CLOCKReplacer implements the clock replacement. A frame is only victimized once the clock hand finds it unreferenced,
+ * frames referenced since the last pass get a second chance.
  */
 class CLOCKReplacer : public Replacer {
  public:
@@ -36,12 +37,19 @@ class CLOCKReplacer : public Replacer {
 
   void Unpin(frame_id_t frame_id) override;
 
+  void Remove(frame_id_t frame_id) override;
+
+  void Hold(frame_id_t frame_id) override;
+
   size_t Size() override;
 
  private:
-  size_t capacity;
-  list<frame_id_t> clock_list;               // replacer中可以被替换的数据页
-  map<frame_id_t, frame_id_t> clock_status;  // 数据页的存储状态
+  size_t capacity_;
+  vector<bool> in_replacer_;  // true for the frames that may be victimized
+  vector<bool> referenced_;   // reference bit, set by Pin and cleared when the clock hand passes the frame
+  size_t hand_{0};            // next frame the clock hand looks at
+  size_t size_{0};            // number of frames that may be victimized
+  mutex latch_;
 };
 
 #endif  // MINISQL_CLOCK_REPLACER_H
\ No newline at end of file
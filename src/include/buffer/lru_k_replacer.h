@@ -0,0 +1,85 @@
+#ifndef MINISQL_LRU_K_REPLACER_H
+#define MINISQL_LRU_K_REPLACER_H
+
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+using namespace std;
+
+/**
+ * LRUKReplacer implements a scan resistant LRU-K replacement policy.
+ *
+ * Time is counted in microseconds of a steady clock, so pins of other frames never change how the pins of a frame
+ * relate to each other. Pins of a frame within correlated_period of the first pin of their run are one correlated
+ * reference, e.g. a table iterator fetching the same page once per row, and only the first of them enters the
+ * reference history. A frame in constant use still gains a new reference every correlated_period. Frames with fewer than K references have an infinite backward K-distance and live in the
+ * history list, which is evicted first in FIFO order. Frames with K references are kept in the cache set ordered by
+ * their K-th most recent reference, so the frame with the largest backward K-distance is evicted first. A one-pass
+ * sequential scan therefore only cycles through the history list and never pushes out hot pages (e.g. B+ tree
+ * internal pages) that have been referenced repeatedly.
+ *
+ * Pin, Unpin and Victim of a history frame are O(1), a cache frame costs O(log n) for the ordered set. Victim skips
+ * held frames, of which there are at most a flusher batch.
+ */
+class LRUKReplacer : public Replacer {
+ public:
+  /**
+   * Create a new LRUKReplacer.
+   * @param num_pages the maximum number of pages the LRUKReplacer will be required to store
+   * @param k the number of references after which a frame is promoted from the history list to the cache set
+   * @param correlated_period the microseconds after a reference to a frame within which its pins are correlated
+   */
+  explicit LRUKReplacer(size_t num_pages, size_t k = DEFAULT_LRU_K,
+                        size_t correlated_period = LRU_K_CORRELATED_US);
+
+  /**
+   * Destroys the LRUKReplacer.
+   */
+  ~LRUKReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  void Hold(frame_id_t frame_id) override;
+
+  void Release(frame_id_t frame_id) override;
+
+  size_t Size() override;
+
+ private:
+  struct FrameEntry {
+    vector<uint64_t> history_;        // times of the last k uncorrelated references, most recent first
+    uint64_t last_{0};                // time of the last pin, correlated or not
+    bool evictable_{false};           // true if the frame is in history_list_ or cache_set_
+    bool held_{false};                // true if the frame stays in history_list_ or cache_set_ but is not a victim
+    list<frame_id_t>::iterator pos_;  // position in history_list_, valid if evictable_ with less than k references
+  };
+
+  /** @return the current time in microseconds */
+  static uint64_t Now();
+
+  /** Take an evictable frame out of history_list_ or cache_set_. */
+  void Erase(FrameEntry &entry, frame_id_t frame_id);
+
+  size_t k_;
+  size_t correlated_period_;
+  vector<FrameEntry> frames_;                  // book-keeping of each frame, indexed by frame id
+  list<frame_id_t> history_list_;              // evictable frames with less than k references, oldest at front
+  set<pair<uint64_t, frame_id_t>> cache_set_;  // evictable frames with k references, by k-th most recent reference
+  size_t size_{0};                             // number of evictable frames that are not held
+  mutex latch_;
+};
+
+#endif  // MINISQL_LRU_K_REPLACER_H
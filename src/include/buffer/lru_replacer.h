@@ -33,11 +33,16 @@ class LRUReplacer : public Replacer {
 
   void Unpin(frame_id_t frame_id) override;
 
+  void Hold(frame_id_t frame_id) override;
+
+  void Release(frame_id_t frame_id) override;
+
   size_t Size() override;
 
 private:
   // add your own private member variables here
   list<frame_id_t> lru_list_;
+  unordered_set<frame_id_t> held_;  // frames in lru_list_ that are not victimized
 };
 
 #endif  // MINISQL_LRU_REPLACER_H
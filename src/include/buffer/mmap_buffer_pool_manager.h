@@ -0,0 +1,61 @@
+#ifndef MINISQL_MMAP_BUFFER_POOL_MANAGER_H
+#define MINISQL_MMAP_BUFFER_POOL_MANAGER_H
+
+#include <mutex>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "page/page.h"
+#include "storage/disk_manager.h"
+
+using namespace std;
+
+/**
+ * MmapBufferPoolManager serves a read-only database straight from a memory mapping of the db file, leaving caching to
+ * the OS page cache. There are no frames and no eviction, and opening the database only reserves address space.
+ *
+ * Every logical page owns a slot of two pages of address space. The first page of the slot is mapped to the physical
+ * page of the file, so the Page handed out by FetchPage has its data at offset 0 just like a regular frame. The
+ * book-keeping of the Page (pin count, latch, ...) spills over into the second, anonymous page of the slot.
+ *
+ * The mapping is private: changes made to a page, e.g. by the catalog on shutdown, are never written to the file.
+ * If a page cannot be mapped, it is read into its slot instead.
+ */
+class MmapBufferPoolManager : public BufferPoolManager {
+ public:
+  explicit MmapBufferPoolManager(DiskManager *disk_manager);
+
+  ~MmapBufferPoolManager() override;
+
+  Page *FetchPage(page_id_t page_id, BufferAccessStrategy *strategy = nullptr) override;
+
+  bool UnpinPage(page_id_t page_id, bool is_dirty) override;
+
+  bool FlushPage(page_id_t page_id) override;
+
+  Page *NewPage(page_id_t &page_id, BufferAccessStrategy *strategy = nullptr) override;
+
+  bool DeletePage(page_id_t page_id) override;
+
+  bool IsPageFree(page_id_t page_id) override;
+
+  size_t GetPoolSize() override { return num_slots_; }
+
+  bool CheckAllUnpinned() override;
+
+ private:
+  static constexpr size_t SLOT_SIZE = 2 * PAGE_SIZE;
+  static_assert(sizeof(Page) <= SLOT_SIZE);
+
+  /** @return the slot of a logical page */
+  inline Page *GetSlot(page_id_t page_id) { return reinterpret_cast<Page *>(slots_ + page_id * SLOT_SIZE); }
+
+  DiskManager *disk_manager_;
+  char *slots_;            // reserved address space, one slot per logical page
+  size_t num_slots_;       // number of logical pages that fit in the file
+  vector<bool> mapped_;    // true if the slot has been set up
+  bool map_failed_{false};  // true once a page could not be mapped, reported only once
+  mutex latch_;            // protects mapped_ and the pin counts
+};
+
+#endif  // MINISQL_MMAP_BUFFER_POOL_MANAGER_H
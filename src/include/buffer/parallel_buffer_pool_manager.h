@@ -0,0 +1,57 @@
+#ifndef MINISQL_PARALLEL_BUFFER_POOL_MANAGER_H
+#define MINISQL_PARALLEL_BUFFER_POOL_MANAGER_H
+
+#include <mutex>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "storage/disk_manager.h"
+
+using namespace std;
+
+/**
+ * ParallelBufferPoolManager shards the buffer pool into independent BufferPoolManagerInstances. A page always lives
+ * in instance (page_id % num_instances), so requests for pages of different shards never contend on the same latch.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * @param num_instances number of shards
+   * @param pool_size total number of frames, split evenly between the shards, the first ones take the remainder
+   * @param replacer_type the replacement policy of the frames of every shard
+   */
+  explicit ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                                     ReplacerType replacer_type = DEFAULT_REPLACER);
+
+  ~ParallelBufferPoolManager() override;
+
+  Page *FetchPage(page_id_t page_id, BufferAccessStrategy *strategy = nullptr) override;
+
+  bool UnpinPage(page_id_t page_id, bool is_dirty) override;
+
+  bool FlushPage(page_id_t page_id) override;
+
+  Page *NewPage(page_id_t &page_id, BufferAccessStrategy *strategy = nullptr) override;
+
+  bool DeletePage(page_id_t page_id) override;
+
+  bool IsPageFree(page_id_t page_id) override;
+
+  size_t GetPoolSize() override;
+
+  void PrefetchPage(page_id_t page_id, size_t chain_length = 1, NextPageFunc next_page = nullptr) override;
+
+  bool CheckAllUnpinned() override;
+
+ private:
+  /** @return the instance responsible for page_id */
+  inline BufferPoolManagerInstance *GetInstance(page_id_t page_id) {
+    return instances_[static_cast<size_t>(page_id) % instances_.size()];
+  }
+
+  DiskManager *disk_manager_;
+  vector<BufferPoolManagerInstance *> instances_;
+};
+
+#endif  // MINISQL_PARALLEL_BUFFER_POOL_MANAGER_H
@@ -33,6 +33,25 @@ class Replacer {
    */
   virtual void Unpin(frame_id_t frame_id) = 0;
 
+  /**
+   * Forgets a frame whose page has been deleted, so that the frame can be returned to the free list.
+   * @param frame_id the id of the frame to remove
+   */
+  virtual void Remove(frame_id_t frame_id) { Pin(frame_id); }
+
+  /**
+   * Keeps an unpinned frame from being victimized without counting a reference to it, e.g. while its page is written
+   * back. The frame keeps its place in the replacement order.
+   * @param frame_id the id of the frame to hold
+   */
+  virtual void Hold(frame_id_t frame_id) { Pin(frame_id); }
+
+  /**
+   * Lets a held frame be victimized again from its old place. A frame pinned since it was held is unpinned instead.
+   * @param frame_id the id of the frame to release
+   */
+  virtual void Release(frame_id_t frame_id) { Unpin(frame_id); }
+
   /** @return the number of elements in the replacer that can be victimized */
   virtual size_t Size() = 0;
 };
@@ -13,8 +13,34 @@ static constexpr int META_PAGE_ID = 0;          // physical page id of the disk
 static constexpr int CATALOG_META_PAGE_ID = 0;  // logical page id of the catalog meta data
 static constexpr int INDEX_ROOTS_PAGE_ID = 1;   // logical page id of the index roots
 
-static constexpr int PAGE_SIZE = 4096;                  // size of a data page in byte
-static constexpr int DEFAULT_BUFFER_POOL_SIZE = 20480;  // default size of buffer pool
+static constexpr int PAGE_SIZE = 4096;                   // size of a data page in byte
+static constexpr int DEFAULT_BUFFER_POOL_SIZE = 20480;   // default size of buffer pool
+static constexpr int DEFAULT_BUFFER_POOL_INSTANCES = 1;  // number of buffer pool shards, 1 disables sharding
+static constexpr int DEFAULT_LRU_K = 2;                  // references before a frame leaves the LRU-K history list
+static constexpr int LRU_K_CORRELATED_US = 10000;        // microseconds a frame's pins count as the same reference
+static constexpr int DIRTY_HIGH_WATERMARK = 40;          // percent of dirty frames that wakes the background flusher
+static constexpr int DIRTY_LOW_WATERMARK = 20;           // percent of dirty frames the background flusher stops at
+static constexpr int FLUSHER_INTERVAL_MS = 100;          // period of the background flusher in milliseconds
+static constexpr int PREFETCH_QUEUE_SIZE = 64;           // pending prefetch requests per buffer pool instance
+static constexpr int TABLE_READ_AHEAD_MIN = 4;           // initial read-ahead window of a table scan in pages
+static constexpr int TABLE_READ_AHEAD_MAX = 64;          // maximum read-ahead window of a table scan in pages
+static constexpr int SCAN_RING_SIZE = 32;                // frames recycled by a large scan in each buffer pool instance
+static constexpr int SCAN_RING_THRESHOLD = 25;           // percent of the pool a scan reads before using its ring
+static constexpr bool ENABLE_DIRECT_IO = false;          // open db files with O_DIRECT, bypassing the OS page cache
+static constexpr int IO_RING_ENTRIES = 64;               // submission queue size of the io_uring of a db file
+static constexpr int IO_BATCH_SIZE = 32;                 // pages written or prefetched by one batch of the buffer pool
+static constexpr bool ENABLE_MMAP_READ_ONLY = false;     // open existing databases read-only through mmap
+static constexpr int INDEX_BUILD_FILL_FACTOR = 90;       // percent of a page filled by a bulk index build
+static constexpr size_t INDEX_SORT_MEMORY = 64 << 20;    // bytes of index entries sorted in memory before spilling
+static constexpr int INDEX_SCAN_BATCH_SIZE = 128;        // row ids an index range scan reads per descent of the tree
+static constexpr size_t HASH_JOIN_MEMORY = 16 << 20;     // bytes of rows a hash join holds before partitioning its inputs
+static constexpr int HASH_JOIN_PARTITIONS = 32;          // partitions of a hash join whose inputs do not fit in memory
+static constexpr uint32_t EXECUTOR_BATCH_SIZE = 1024;    // rows an executor produces per call of NextBatch
+static constexpr int PARALLEL_SCAN_WORKERS = 0;          // threads of a parallel table scan, 0 for one per core
+static constexpr int PARALLEL_SCAN_MORSEL_PAGES = 4;     // pages a worker of a parallel table scan claims at a time
+
+enum ReplacerType { kLRUReplacer, kLRUKReplacer, kClockReplacer };
+static constexpr ReplacerType DEFAULT_REPLACER = kLRUKReplacer;  // replacement policy of the buffer pool frames
 
 static constexpr uint32_t FIELD_NULL_LEN = UINT32_MAX;
 static constexpr uint32_t VARCHAR_MAX_LEN = PAGE_SIZE / 2;  // max length of varchar
@@ -5,6 +5,9 @@
 #include <string>
 
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/mmap_buffer_pool_manager.h"
+#include "buffer/parallel_buffer_pool_manager.h"
 #include "catalog/catalog.h"
 #include "common/config.h"
 #include "common/dberr.h"
@@ -14,7 +17,13 @@
 
 class DBStorageEngine {
  public:
-  explicit DBStorageEngine(std::string db_name, bool init = true, uint32_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE);
+  /**
+   * @param read_only serve the database read-only from a memory mapping of its file, see MmapBufferPoolManager.
+   *                  Ignored when a new database is created (init is true).
+   */
+  explicit DBStorageEngine(std::string db_name, bool init = true, uint32_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE,
+                           uint32_t buffer_pool_instances = DEFAULT_BUFFER_POOL_INSTANCES,
+                           bool read_only = ENABLE_MMAP_READ_ONLY);
 
   ~DBStorageEngine();
 
@@ -26,6 +35,7 @@ class DBStorageEngine {
   CatalogManager *catalog_mgr_;
   std::string db_file_name_;
   bool init_;
+  bool read_only_;  // pages are served by MmapBufferPoolManager and nothing may be written
 };
 
 #endif  // MINISQL_INSTANCE_H
@@ -34,6 +34,12 @@ class ExecuteContext {
   /** @return the buffer pool manager */
   BufferPoolManager *GetBufferPoolManager() { return bpm_; }
 
+  /** @return the access strategy of the bulk load the statement belongs to, nullptr if none */
+  BufferAccessStrategy *GetAccessStrategy() { return strategy_; }
+
+  /** Set the access strategy shared by all statements of a bulk load */
+  void SetAccessStrategy(BufferAccessStrategy *strategy) { strategy_ = strategy; }
+
  private:
   /** The recovery context associated with this executor context */
   Txn *transaction_;
@@ -41,6 +47,8 @@ class ExecuteContext {
   CatalogManager *catalog_;
   /** The buffer pool manager associated with this executor context */
   BufferPoolManager *bpm_;
+  /** The access strategy of the bulk load this context belongs to */
+  BufferAccessStrategy *strategy_{nullptr};
 };
 
 #endif  // MINISQL_EXECUTE_CONTEXT_H
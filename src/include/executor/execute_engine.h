@@ -78,6 +78,7 @@ class ExecuteEngine {
  private:
   std::unordered_map<std::string, DBStorageEngine *> dbs_; /** all opened databases */
   std::string current_db_;                                 /** current database */
+  BufferAccessStrategy *bulk_strategy_{nullptr};           /** strategy of the execfile statement being run */
 };
 
 #endif  // MINISQL_EXECUTE_ENGINE_H
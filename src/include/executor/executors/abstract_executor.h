@@ -2,8 +2,10 @@
 #define MINISQL_ABSTRACT_EXECUTOR_H
 
 #include "executor/execute_context.h"
+#include "executor/row_batch.h"
+
 /**
- * The AbstractExecutor implements the Volcano row-at-a-time iterator model.
+ * The AbstractExecutor implements the Volcano row-at-a-time iterator model, and its batch-at-a-time counterpart.
  * This is the base class from which all executors in the execution engine
  * inherit, and defines the minimal interface that all executors support.
  */
@@ -32,6 +34,27 @@ class AbstractExecutor {
    */
   virtual bool Next(Row *row, RowId *rid) = 0;
 
+  /**
+   * Yield the next batch of rows from this executor.
+   * The default pulls the rows one at a time with Next(), executors override it to produce a whole batch at once.
+   * @param[out] batch The rows produced, those to use are the selected ones
+   * @return `true` if at least one row was produced, `false` if there are no more rows
+   */
+  virtual bool NextBatch(RowBatch *batch) {
+    batch->Clear();
+    RowId rid;
+    while (!batch->IsFull()) {
+      Row &row = batch->Append();
+      if (!Next(&row, &rid)) {
+        batch->PopBack();
+        break;
+      }
+      row.SetRowId(rid);
+    }
+    batch->SelectAll();
+    return batch->Size() > 0;
+  }
+
   /** @return The schema of the rows that this executor produces */
   virtual const Schema *GetOutputSchema() const = 0;
 
@@ -40,10 +40,20 @@ class DeleteExecutor : public AbstractExecutor {
    */
   bool Next(Row *row, RowId *rid) override;
 
+  /**
+   * Yield the next batch of rows from the delete: delete the rows of a batch of the child in order.
+   * @param[out] batch The rows deleted, a row that cannot be deleted ends the delete as in Next()
+   * @return `true` if at least one row was deleted, `false` if there are no more rows
+   */
+  bool NextBatch(RowBatch *batch) override;
+
   /** @return The output schema for the delete */
   const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
 
  private:
+  /** Delete a row of the table and its index entries, @return false if the row could not be deleted */
+  bool DeleteRow(Row &row, const RowId &rid);
+
   /** The delete plan node to be executed */
   const DeletePlanNode *plan_;
   TableInfo *table_info_{};
@@ -51,6 +61,8 @@ class DeleteExecutor : public AbstractExecutor {
   std::vector<IndexInfo *> index_info_;
   /** The child executor from which RIDs for deleted rows are pulled */
   std::unique_ptr<AbstractExecutor> child_executor_;
+  /** True once a row could not be deleted */
+  bool done_{false};
 };
 
 #endif  // MINISQL_DELETE_EXECUTOR_H
@@ -0,0 +1,116 @@
+#ifndef MINISQL_HASH_JOIN_EXECUTOR_H
+#define MINISQL_HASH_JOIN_EXECUTOR_H
+
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "executor/execute_context.h"
+#include "executor/executors/abstract_executor.h"
+#include "executor/plans/hash_join_plan.h"
+
+/**
+ * HashJoinExecutor executes an inner equi-join, building a hash table on the smaller input and probing it with the
+ * other one.
+ *
+ * Both inputs are read in turns until one of them ends, which tells the smaller one without statistics. If that one
+ * fits in memory_limit bytes, it becomes the build side and the rest of the other input is streamed. Otherwise both
+ * inputs are hashed on their keys into HASH_JOIN_PARTITIONS pairs of temporary files, and the pairs are joined one
+ * after the other, each building on its smaller file. A pair larger than the memory limit is still joined in memory.
+ *
+ * Rows whose key has a NULL never match and are dropped as they are read.
+ */
+class HashJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new HashJoinExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The hash join plan to be executed
+   * @param left_executor The executor of the left input
+   * @param right_executor The executor of the right input
+   * @param memory_limit The bytes of rows held in memory before the inputs are partitioned
+   */
+  HashJoinExecutor(ExecuteContext *exec_ctx, const HashJoinPlanNode *plan,
+                   std::unique_ptr<AbstractExecutor> &&left_executor,
+                   std::unique_ptr<AbstractExecutor> &&right_executor, size_t memory_limit = HASH_JOIN_MEMORY);
+
+  ~HashJoinExecutor() override;
+
+  /** Initialize the join, reading the build side */
+  void Init() override;
+
+  /**
+   * Yield the next row from the join.
+   * @param[out] row The next row produced by the join
+   * @param[out] rid Not a row of a table, always set to an invalid RowId
+   * @return `true` if a row was produced, `false` if there are no more rows
+   */
+  bool Next(Row *row, RowId *rid) override;
+
+  /** @return The output schema for the join */
+  const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
+
+ private:
+  /** The rows of both inputs with the same hash partition, spilled to temporary files */
+  struct Partition {
+    FILE *files_[2]{nullptr, nullptr};  // left and right rows
+    size_t sizes_[2]{0, 0};             // bytes written to each file
+  };
+
+  /**
+   * Encode the join key of a row of one input, so that equal keys have equal encodings.
+   * @return false if a key column is NULL
+   */
+  bool MakeKey(const Row &row, int side, std::string &key) const;
+
+  /** @return the bytes a row takes in memory, roughly */
+  static size_t RowSize(const Row &row);
+
+  /** Hash the build rows, which are taken from build_rows_ */
+  void BuildTable();
+
+  /** Hash both inputs into partitions, starting with the rows already read */
+  void PartitionInputs(std::deque<Row> (&rows)[2]);
+
+  /** @return the bytes written */
+  size_t WriteRow(FILE *file, const Row &row);
+
+  /** @return false at the end of the file */
+  bool ReadRow(FILE *file, int side, Row &row);
+
+  /** Load the build rows of the next partition into the hash table, @return false if there is none left */
+  bool LoadNextPartition();
+
+  /** Read the next probe row, from the buffered rows, the input or the current partition */
+  bool NextProbeRow(Row &row);
+
+  /** Join a probe row with a matching build row into the output row, @return false if the predicate rejects them */
+  bool JoinRows(const Row &probe_row, const Row &build_row, Row *row) const;
+
+  /** The hash join plan node to be executed */
+  const HashJoinPlanNode *plan_;
+  /** The executors of the left and right inputs */
+  std::unique_ptr<AbstractExecutor> children_[2];
+  size_t memory_limit_;
+  /** True if the output is the joined row as is */
+  bool is_schema_same_{false};
+  /** 0 if the left input is the build side, 1 if the right one is */
+  int build_side_{0};
+  std::deque<Row> build_rows_;
+  std::unordered_multimap<std::string, const Row *> hash_table_;
+  /** Probe rows read while looking for the smaller input, returned before the rest of the probe input */
+  std::deque<Row> probe_rows_;
+  bool partitioned_{false};
+  std::vector<Partition> partitions_;
+  size_t next_partition_{0};
+  FILE *probe_file_{nullptr};  // the probe rows of the partition being joined
+  Row probe_row_;
+  std::unordered_multimap<std::string, const Row *>::const_iterator match_, match_end_;
+  std::vector<char> buffer_;  // serialized row read from a partition
+};
+
+#endif  // MINISQL_HASH_JOIN_EXECUTOR_H
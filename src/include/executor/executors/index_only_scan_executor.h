@@ -0,0 +1,29 @@
+#pragma once
+
+#include <vector>
+
+#include "executor/executors/index_scan_executor.h"
+#include "executor/plans/index_only_scan_plan.h"
+
+/**
+ * The IndexOnlyScanExecutor scans an index like the IndexScanExecutor, but builds its rows from the key columns of
+ * the index entries instead of fetching them from the table heap.
+ */
+class IndexOnlyScanExecutor : public IndexScanExecutor {
+ public:
+  IndexOnlyScanExecutor(ExecuteContext *exec_ctx, const IndexOnlyScanPlanNode *plan);
+
+  /** Initialize the index scan, and map the output and predicate columns to the key columns of the index */
+  void Init() override;
+
+  bool Next(Row *row, RowId *rid) override;
+
+  /** Rows are built from the keys one at a time, the rows fetched by IndexScanExecutor::NextBatch are not used */
+  bool NextBatch(RowBatch *batch) override { return AbstractExecutor::NextBatch(batch); }
+
+ private:
+  /** The position in the key of each output column */
+  std::vector<uint32_t> output_keys_;
+  /** The position in the key of each table column, -1 if it is not a key column */
+  std::vector<int> table_keys_;
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "executor/execute_context.h"
@@ -31,6 +32,13 @@ class IndexScanExecutor : public AbstractExecutor {
    */
   bool Next(Row *row, RowId *rid) override;
 
+  /**
+   * Yield the next batch of rows from the index scan.
+   * @param[out] batch The rows produced by the scan
+   * @return `true` if at least one row was produced, `false` if there are no more rows
+   */
+  bool NextBatch(RowBatch *batch) override;
+
   /** @return The output schema for the sequential scan */
   const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
 
@@ -38,13 +46,40 @@ class IndexScanExecutor : public AbstractExecutor {
 
   void TupleTransfer(const Schema *table_schema, const Schema *output_schema, const Row *row, Row *output_row);
 
- private:
-  vector<RowId> IndexScan(AbstractExpressionRef predicate);
+ protected:
+  /** Bounds on one key column, gathered from the comparisons of the predicate */
+  struct ColumnRange {
+    std::unique_ptr<Field> low_;
+    bool low_inclusive_{false};
+    std::unique_ptr<Field> high_;
+    bool high_inclusive_{false};
+    size_t folded_{0};  // number of comparisons of the predicate folded into the bounds
+
+    /** @return true if the bounds pin the column to a single value */
+    bool IsPoint() const {
+      return low_ != nullptr && high_ != nullptr && low_inclusive_ && high_inclusive_ &&
+             low_->CompareEquals(*high_) == kTrue;
+    }
+  };
+
+  /** Bounds on the key columns of an index. The scan uses the leading point columns and a range on the next one. */
+  struct KeyRange {
+    IndexInfo *index_{nullptr};
+    std::vector<ColumnRange> columns_;
+    size_t prefix_{0};  // number of leading key columns pinned to a single value
+  };
+
+  /** Fold the comparisons of a conjunctive predicate into the ranges of the index key columns they compare. */
+  static void CollectRanges(const AbstractExpressionRef &predicate, std::vector<KeyRange> &ranges,
+                            size_t &comparisons);
 
   /** The sequential scan plan node to be executed */
   const IndexScanPlanNode *plan_;
   TableInfo *table_info_{};
-  vector<RowId> result_;
-  size_t cursor_ = 0;
+  IndexInfo *index_info_{};  // the index chosen for the scan
+  std::unique_ptr<IndexRangeScan> scan_;
+  bool need_filter_{true};  // false if the range of the scan is exactly the predicate
   bool is_schema_same_;
+  /** The rows fetched by NextBatch when they are projected, as many as the output batch holds */
+  RowBatch input_;
 };
\ No newline at end of file
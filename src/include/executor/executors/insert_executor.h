@@ -38,16 +38,28 @@ class InsertExecutor : public AbstractExecutor {
    */
   bool Next([[maybe_unused]] Row *row, RowId *rid) override;
 
+  /**
+   * Yield the next batch of rows from the insert: insert the rows of a batch of the child in order.
+   * @param[out] batch The rows inserted, a row that cannot be inserted ends the insert as in Next()
+   * @return `true` if at least one row was inserted, `false` if there are no more rows
+   */
+  bool NextBatch(RowBatch *batch) override;
+
   /** @return The output schema for the insert */
   const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
 
  private:
+  /** Insert a row into the table and its indexes, @return false if the row breaks a unique index or does not fit */
+  bool InsertRow(Row &row);
+
   /** The insert plan node to be executed*/
   const InsertPlanNode *plan_;
   std::unique_ptr<AbstractExecutor> child_executor_;
   TableInfo *table_info_{};
   const Schema *schema_{};
   std::vector<IndexInfo *> index_info_;
+  /** True once a row could not be inserted */
+  bool done_{false};
 };
 
 #endif  // MINISQL_INSERT_EXECUTOR_H
@@ -0,0 +1,57 @@
+#ifndef MINISQL_NESTED_INDEX_JOIN_EXECUTOR_H
+#define MINISQL_NESTED_INDEX_JOIN_EXECUTOR_H
+
+#include <memory>
+
+#include "executor/execute_context.h"
+#include "executor/executors/abstract_executor.h"
+#include "executor/plans/nested_index_join_plan.h"
+
+/**
+ * NestedIndexJoinExecutor executes an inner equi-join by looking up every outer row in an index of the inner table.
+ *
+ * The outer side is streamed, and the inner rows matching an outer row are read from the table heap as the index
+ * scan of its key returns them, so the inner table is never scanned in full.
+ */
+class NestedIndexJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new NestedIndexJoinExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The nested index join plan to be executed
+   * @param child_executor The executor of the outer side
+   */
+  NestedIndexJoinExecutor(ExecuteContext *exec_ctx, const NestedIndexJoinPlanNode *plan,
+                          std::unique_ptr<AbstractExecutor> &&child_executor);
+
+  /** Initialize the join */
+  void Init() override;
+
+  /**
+   * Yield the next row from the join.
+   * @param[out] row The next row produced by the join
+   * @param[out] rid Not a row of a table, always set to an invalid RowId
+   * @return `true` if a row was produced, `false` if there are no more rows
+   */
+  bool Next(Row *row, RowId *rid) override;
+
+  /** @return The output schema for the join */
+  const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
+
+ private:
+  /** Start the index scan of the key of outer_row_, scan_ is left null if the key has a NULL */
+  void LookUp();
+
+  /** The nested index join plan node to be executed */
+  const NestedIndexJoinPlanNode *plan_;
+  /** The executor of the outer side */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  TableInfo *inner_table_{};
+  /** True if the output is the joined row as is */
+  bool is_schema_same_{false};
+  Row outer_row_;
+  /** The scan of the inner rows matching outer_row_ */
+  std::unique_ptr<IndexRangeScan> scan_;
+};
+
+#endif  // MINISQL_NESTED_INDEX_JOIN_EXECUTOR_H
@@ -5,6 +5,12 @@
 #ifndef MINISQL_SEQ_SCAN_EXECUTOR_H
 #define MINISQL_SEQ_SCAN_EXECUTOR_H
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "executor/execute_context.h"
@@ -23,6 +29,9 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   SeqScanExecutor(ExecuteContext *exec_ctx, const SeqScanPlanNode *plan);
 
+  /** Stop the workers of a parallel scan */
+  ~SeqScanExecutor() override;
+
   /** Initialize the sequential scan */
   void Init() override;
 
@@ -34,6 +43,13 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   bool Next(Row *row, RowId *rid) override;
 
+  /**
+   * Yield the next batch of rows from the sequential scan.
+   * @param[out] batch The rows produced by the scan
+   * @return `true` if at least one row was produced, `false` if there are no more rows
+   */
+  bool NextBatch(RowBatch *batch) override;
+
   /** @return The output schema for the sequential scan */
   const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
 
@@ -42,12 +58,62 @@ class SeqScanExecutor : public AbstractExecutor {
   void TupleTransfer(const Schema *table_schema, const Schema *output_schema, const Row *row, Row *output_row);
 
  private:
+  /** Start the workers of a parallel scan, unless the plan or the table is too small for one */
+  void StartWorkers();
+
+  /** Stop the workers and drop the rows they have not handed out yet */
+  void StopWorkers();
+
+  /** Worker loop: claim the next morsel of pages, scan it and store its rows until the table is done */
+  void ScanMorsels();
+
+  /** Read the rows of a page, then filter and project them */
+  void ScanPage(TablePage *page, std::deque<Row> &rows);
+
+  /**
+   * Wait for the next morsel in page order and move its rows into current_.
+   * @return `false` once all morsels have been handed out
+   * @throws std::runtime_error if a worker could not fetch a page
+   */
+  bool NextMorsel();
+
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
   TableInfo *table_info_{};
   TableIterator iterator_;
+  /** Keeps a scan larger than SCAN_RING_THRESHOLD percent of the pool from flushing out the hot pages */
+  BufferAccessStrategy strategy_;
   const Schema *schema_{};
   bool is_schema_same_;
+  /** The rows read by NextBatch when they are projected, as many as the output batch holds */
+  RowBatch input_;
+
+  /** Parallel scan: the table is cut into morsels of PARALLEL_SCAN_MORSEL_PAGES pages claimed by the workers */
+  std::vector<std::thread> workers_;
+  /** Held by the worker that walks the page chain, protects next_page_id_ and pages_until_read_ahead_ */
+  std::mutex cursor_latch_;
+  /** The first page of the next morsel, INVALID_PAGE_ID when all pages are claimed */
+  page_id_t next_page_id_{INVALID_PAGE_ID};
+  size_t pages_until_read_ahead_{0};
+  /** Protects all the members below, except current_ which is only used by the thread of the executor */
+  std::mutex latch_;
+  /** Signaled when a worker has stored a morsel */
+  std::condition_variable morsel_done_;
+  /** Signaled when a morsel is handed out, so workers may claim more */
+  std::condition_variable window_open_;
+  /** True once the last morsel is claimed, or a worker failed */
+  bool cursor_done_{false};
+  /** Why a worker failed, empty if none did */
+  std::string error_;
+  size_t morsels_claimed_{0};
+  size_t morsels_returned_{0};
+  /** Morsels that may be claimed ahead of the one handed out next, bounding the rows held in done_ */
+  size_t window_{0};
+  bool stop_{false};
+  /** Rows of the morsels that are scanned but not handed out yet, by morsel number */
+  std::unordered_map<size_t, std::deque<Row>> done_;
+  /** Rows of the morsel being handed out */
+  std::deque<Row> current_;
 };
 
 #endif  // MINISQL_SEQ_SCAN_EXECUTOR_H
@@ -40,6 +40,13 @@ class UpdateExecutor : public AbstractExecutor {
    */
   bool Next([[maybe_unused]] Row *row, RowId *rid) override;
 
+  /**
+   * Yield the next batch of rows from the update: update the rows of a batch of the child in order.
+   * @param[out] batch The rows updated, a row that cannot be updated ends the update as in Next()
+   * @return `true` if at least one row was updated, `false` if there are no more rows
+   */
+  bool NextBatch(RowBatch *batch) override;
+
   /** @return The output schema for the update */
   const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
 
@@ -51,6 +58,9 @@ class UpdateExecutor : public AbstractExecutor {
    */
   Row GenerateUpdatedTuple(const Row &src_row);
 
+  /** Update a row of the table and its index entries, @return false if the row could not be updated */
+  bool UpdateRow(Row &src_row, const RowId &src_rid);
+
   /** The update plan node to be executed */
   const UpdatePlanNode *plan_;
   /** Metadata identifying the table that should be updated */
@@ -59,6 +69,8 @@ class UpdateExecutor : public AbstractExecutor {
   std::vector<IndexInfo *> index_info_;
   /** The child executor to obtain value from */
   std::unique_ptr<AbstractExecutor> child_executor_;
+  /** True once a row could not be updated */
+  bool done_{false};
 };
 
 #endif  // MINISQL_UPDATE_EXECUTOR_H
@@ -15,6 +15,7 @@
 enum class PlanType {
   SeqScan,
   IndexScan,
+  IndexOnlyScan,
   Insert,
   Update,
   Delete,
@@ -23,6 +24,8 @@ enum class PlanType {
   Limit,
   Distinct,
   NestedLoopJoin,
+  HashJoin,
+  NestedIndexJoin,
 };
 
 class AbstractPlanNode;
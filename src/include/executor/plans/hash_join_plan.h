@@ -0,0 +1,69 @@
+#ifndef MINISQL_HASH_JOIN_PLAN_H
+#define MINISQL_HASH_JOIN_PLAN_H
+
+#include <utility>
+#include <vector>
+
+#include "abstract_plan.h"
+#include "planner/expressions/abstract_expression.h"
+
+/**
+ * HashJoinPlanNode joins the rows of its two children whose join keys are equal.
+ *
+ * A joined row has the columns of the left row followed by those of the right row. The predicate, if any, is evaluated
+ * on the joined row, and the output columns are taken from it by their GetTableInd().
+ */
+class HashJoinPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Construct a new HashJoinPlanNode instance.
+   * @param output The output schema of the join
+   * @param left The plan of the left input
+   * @param right The plan of the right input
+   * @param left_key_expressions The join keys, evaluated on the left rows
+   * @param right_key_expressions The join keys, evaluated on the right rows, in the same order
+   * @param predicate The condition the joined rows must meet besides equal keys, may be null
+   */
+  HashJoinPlanNode(const Schema *output, AbstractPlanNodeRef left, AbstractPlanNodeRef right,
+                   std::vector<AbstractExpressionRef> left_key_expressions,
+                   std::vector<AbstractExpressionRef> right_key_expressions, AbstractExpressionRef predicate = nullptr)
+      : AbstractPlanNode(output, {std::move(left), std::move(right)}),
+        left_key_expressions_(std::move(left_key_expressions)),
+        right_key_expressions_(std::move(right_key_expressions)),
+        predicate_(std::move(predicate)) {}
+
+  /** @return The type of the plan node */
+  PlanType GetType() const override { return PlanType::HashJoin; }
+
+  /** @return The left plan node of the hash join */
+  AbstractPlanNodeRef GetLeftPlan() const {
+    ASSERT(GetChildren().size() == 2, "Hash joins should have exactly two children plans.");
+    return GetChildAt(0);
+  }
+
+  /** @return The right plan node of the hash join */
+  AbstractPlanNodeRef GetRightPlan() const {
+    ASSERT(GetChildren().size() == 2, "Hash joins should have exactly two children plans.");
+    return GetChildAt(1);
+  }
+
+  /** @return The join keys of the left input */
+  const std::vector<AbstractExpressionRef> &LeftJoinKeyExpressions() const { return left_key_expressions_; }
+
+  /** @return The join keys of the right input */
+  const std::vector<AbstractExpressionRef> &RightJoinKeyExpressions() const { return right_key_expressions_; }
+
+  /** @return The predicate on the joined rows */
+  AbstractExpressionRef GetPredicate() const { return predicate_; }
+
+  /** The join keys of the left input, an empty list joins every pair of rows */
+  std::vector<AbstractExpressionRef> left_key_expressions_;
+
+  /** The join keys of the right input */
+  std::vector<AbstractExpressionRef> right_key_expressions_;
+
+  /** The predicate on the joined rows */
+  AbstractExpressionRef predicate_;
+};
+
+#endif  // MINISQL_HASH_JOIN_PLAN_H
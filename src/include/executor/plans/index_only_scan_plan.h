@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+#include <utility>
+
+#include "executor/plans/index_scan_plan.h"
+
+/**
+ * IndexOnlyScanPlanNode is an index scan whose indexes hold every column of the output and of the predicate in their
+ * key, so rows are decoded from the index entries and the table is never read.
+ */
+class IndexOnlyScanPlanNode : public IndexScanPlanNode {
+ public:
+  IndexOnlyScanPlanNode(const Schema *output, std::string table_name, std::vector<IndexInfo *> indexes,
+                        bool need_filter, AbstractExpressionRef filter_predicate = nullptr)
+      : IndexScanPlanNode(output, std::move(table_name), std::move(indexes), need_filter,
+                          std::move(filter_predicate)) {}
+
+  /** @return The type of the plan node */
+  PlanType GetType() const override { return PlanType::IndexOnlyScan; }
+};
@@ -6,6 +6,7 @@
 #include "abstract_plan.h"
 #include "catalog/catalog.h"
 #include "planner/expressions/abstract_expression.h"
+#include "planner/expressions/compiled_predicate.h"
 
 /**
  * IndexScanPlanNode identifies a table that should be scanned with an optional predicate.
@@ -23,7 +24,11 @@ class IndexScanPlanNode : public AbstractPlanNode {
         table_name_(std::move(table_name)),
         indexes_(std::move(indexes)),
         need_filter_(need_filter),
-        filter_predicate_(std::move(filter_predicate)) {}
+        filter_predicate_(std::move(filter_predicate)) {
+    if (filter_predicate_ != nullptr) {
+      compiled_predicate_ = std::make_shared<CompiledPredicate>(filter_predicate_);
+    }
+  }
 
   /** @return The type of the plan node */
   PlanType GetType() const override { return PlanType::IndexScan; }
@@ -33,6 +38,9 @@ class IndexScanPlanNode : public AbstractPlanNode {
 
   AbstractExpressionRef GetPredicate() const { return filter_predicate_; }
 
+  /** @return The predicate compiled for evaluation, null if there is no predicate */
+  const CompiledPredicate *GetCompiledPredicate() const { return compiled_predicate_.get(); }
+
   /** The table name */
   std::string table_name_;
 
@@ -44,4 +52,7 @@ class IndexScanPlanNode : public AbstractPlanNode {
 
   /** The predicate to filter in IndexScan.*/
   AbstractExpressionRef filter_predicate_;
+
+  /** The predicate compiled when the plan is built */
+  std::shared_ptr<CompiledPredicate> compiled_predicate_;
 };
\ No newline at end of file
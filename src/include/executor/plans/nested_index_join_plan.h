@@ -0,0 +1,73 @@
+#ifndef MINISQL_NESTED_INDEX_JOIN_PLAN_H
+#define MINISQL_NESTED_INDEX_JOIN_PLAN_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "abstract_plan.h"
+#include "catalog/catalog.h"
+#include "planner/expressions/abstract_expression.h"
+
+/**
+ * NestedIndexJoinPlanNode joins the rows of its child, the outer side, with the rows of a table found through an
+ * index on it: the leading key columns of the index are looked up with the values of the key expressions.
+ *
+ * A joined row has the columns of the outer row followed by those of the table row. The predicate, if any, is
+ * evaluated on the joined row, and the output columns are taken from it by their GetTableInd().
+ */
+class NestedIndexJoinPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Construct a new NestedIndexJoinPlanNode instance.
+   * @param output The output schema of the join
+   * @param child The plan of the outer side
+   * @param inner_table_name The table looked up through the index
+   * @param index The index looked up, on the inner table
+   * @param key_expressions The values of the leading key columns of the index, evaluated on the outer rows
+   * @param predicate The condition the joined rows must meet besides matching keys, may be null
+   */
+  NestedIndexJoinPlanNode(const Schema *output, AbstractPlanNodeRef child, std::string inner_table_name,
+                          IndexInfo *index, std::vector<AbstractExpressionRef> key_expressions,
+                          AbstractExpressionRef predicate = nullptr)
+      : AbstractPlanNode(output, {std::move(child)}),
+        inner_table_name_(std::move(inner_table_name)),
+        index_(index),
+        key_expressions_(std::move(key_expressions)),
+        predicate_(std::move(predicate)) {}
+
+  /** @return The type of the plan node */
+  PlanType GetType() const override { return PlanType::NestedIndexJoin; }
+
+  /** @return The plan node of the outer side */
+  AbstractPlanNodeRef GetChildPlan() const {
+    ASSERT(GetChildren().size() == 1, "Nested index joins should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+  /** @return The name of the inner table */
+  std::string GetInnerTableName() const { return inner_table_name_; }
+
+  /** @return The index of the inner table */
+  IndexInfo *GetIndex() const { return index_; }
+
+  /** @return The values looked up in the index, evaluated on the outer rows */
+  const std::vector<AbstractExpressionRef> &KeyExpressions() const { return key_expressions_; }
+
+  /** @return The predicate on the joined rows */
+  AbstractExpressionRef GetPredicate() const { return predicate_; }
+
+  /** The inner table */
+  std::string inner_table_name_;
+
+  /** The index looked up on the inner table */
+  IndexInfo *index_;
+
+  /** One expression for each leading key column of the index looked up */
+  std::vector<AbstractExpressionRef> key_expressions_;
+
+  /** The predicate on the joined rows */
+  AbstractExpressionRef predicate_;
+};
+
+#endif  // MINISQL_NESTED_INDEX_JOIN_PLAN_H
@@ -8,6 +8,7 @@
 #include "abstract_plan.h"
 #include "catalog/catalog.h"
 #include "planner/expressions/abstract_expression.h"
+#include "planner/expressions/compiled_predicate.h"
 
 class SeqScanPlanNode : public AbstractPlanNode {
  public:
@@ -15,11 +16,18 @@ class SeqScanPlanNode : public AbstractPlanNode {
    * Construct a new SeqScanPlanNode instance.
    * @param output The output schema of this sequential scan plan node
    * @param table_name The identifier of table to be scanned
+   * @param parallelism The number of threads scanning the table, 1 to scan it on the thread of the executor
    */
-  SeqScanPlanNode(const Schema *output, std::string table_name, AbstractExpressionRef filter_predicate = nullptr)
+  SeqScanPlanNode(const Schema *output, std::string table_name, AbstractExpressionRef filter_predicate = nullptr,
+                  size_t parallelism = 1)
       : AbstractPlanNode(output, {}),
         table_name_(std::move(table_name)),
-        filter_predicate_(std::move(filter_predicate)) {}
+        filter_predicate_(std::move(filter_predicate)),
+        parallelism_(parallelism) {
+    if (filter_predicate_ != nullptr) {
+      compiled_predicate_ = std::make_shared<CompiledPredicate>(filter_predicate_);
+    }
+  }
 
   /** @return The type of the plan node */
   PlanType GetType() const override { return PlanType::SeqScan; }
@@ -29,11 +37,23 @@ class SeqScanPlanNode : public AbstractPlanNode {
 
   AbstractExpressionRef GetPredicate() const { return filter_predicate_; }
 
+  /** @return The predicate compiled for evaluation, null if there is no predicate */
+  const CompiledPredicate *GetCompiledPredicate() const { return compiled_predicate_.get(); }
+
+  /** @return The number of threads scanning the table */
+  size_t GetParallelism() const { return parallelism_; }
+
   /** The table name */
   std::string table_name_;
 
   /** The predicate to filter in SeqScan.*/
   AbstractExpressionRef filter_predicate_;
+
+  /** The predicate compiled when the plan is built */
+  std::shared_ptr<CompiledPredicate> compiled_predicate_;
+
+  /** The number of threads scanning the table */
+  size_t parallelism_;
 };
 
 #endif  // MINISQL_SEQ_SCAN_PLAN_H
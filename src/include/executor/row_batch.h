@@ -0,0 +1,66 @@
+#ifndef MINISQL_ROW_BATCH_H
+#define MINISQL_ROW_BATCH_H
+
+#include <vector>
+
+#include "common/config.h"
+#include "record/row.h"
+
+/**
+ * RowBatch holds the rows an executor produces with one call of NextBatch().
+ *
+ * The rows are kept in slots that are allocated once and reused by every batch, each row carrying its RowId. A
+ * filter does not move rows around: it narrows the selection, the positions of the rows that are actually produced,
+ * which are kept in increasing order.
+ */
+class RowBatch {
+ public:
+  explicit RowBatch(uint32_t capacity = EXECUTOR_BATCH_SIZE) : rows_(capacity) { selection_.reserve(capacity); }
+
+  /** Empty the batch, the slots keep their fields until they are filled again */
+  void Clear() {
+    size_ = 0;
+    selection_.clear();
+  }
+
+  /** @return The next free slot, to be filled by the caller */
+  Row &Append() {
+    ASSERT(size_ < rows_.size(), "Row batch is full.");
+    return rows_[size_++];
+  }
+
+  /** Give back the slot taken by the last Append() */
+  void PopBack() { size_--; }
+
+  /** Select every row of the batch */
+  void SelectAll() {
+    selection_.resize(size_);
+    for (uint32_t i = 0; i < size_; i++) {
+      selection_[i] = i;
+    }
+  }
+
+  inline Row &GetRow(uint32_t idx) { return rows_[idx]; }
+
+  /** @return The slots, the first Size() of them hold the rows of the batch */
+  inline std::vector<Row> &GetRows() { return rows_; }
+
+  /** @return The positions of the rows produced, in increasing order */
+  inline std::vector<uint32_t> &GetSelection() { return selection_; }
+
+  inline uint32_t Size() const { return size_; }
+
+  /** Set the number of slots filled, after writing into GetRows() directly */
+  inline void SetSize(uint32_t size) { size_ = size; }
+
+  inline uint32_t Capacity() const { return rows_.size(); }
+
+  inline bool IsFull() const { return size_ == rows_.size(); }
+
+ private:
+  std::vector<Row> rows_;
+  uint32_t size_{0};
+  std::vector<uint32_t> selection_;
+};
+
+#endif  // MINISQL_ROW_BATCH_H
@@ -1,12 +1,15 @@
 #ifndef MINISQL_B_PLUS_TREE_H
 #define MINISQL_B_PLUS_TREE_H
 
+#include <fstream>
 #include <queue>
 #include <string>
 #include <vector>
 
+#include "common/rwlatch.h"
 #include "concurrency/txn.h"
 #include "index/index_iterator.h"
+#include "index/index_key_sorter.h"
 #include "page/b_plus_tree_internal_page.h"
 #include "page/b_plus_tree_leaf_page.h"
 #include "page/b_plus_tree_page.h"
@@ -16,10 +19,19 @@
  *
  * Implementation of simple b+ tree data structure where internal pages direct
  * the search and leaf pages contain actual data.
- * (1) We only support unique key
+ * (1) Keys in the tree are unique, a non-unique index makes them so by appending the row id (see KeyManager)
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
+ *
+ * Concurrency control is done by latch crabbing on the page latches:
+ * - Lookups read latch the pages from the root down, releasing a page once its child is latched.
+ * - Inserts and removes first descend optimistically like a lookup and write latch only the leaf. If the leaf could
+ *   split or underflow, they start over and write latch the whole path, releasing the ancestors (and root_latch_)
+ *   whenever a page is safe, i.e. cannot split or underflow.
+ * - A pessimistic remove also latches the sibling it may borrow from or merge with, always left before right, so it
+ *   never waits on a page left of one it holds. Index iterators move left to right with read latch coupling, so the
+ *   two cannot deadlock.
  */
 class BPlusTree {
   using InternalPage = BPlusTreeInternalPage;
@@ -41,21 +53,27 @@ class BPlusTree {
   // return the value associated with a given key
   bool GetValue(const GenericKey *key, std::vector<RowId> &result, Txn *transaction = nullptr);
 
+  // Build an empty tree bottom-up from sorted entries, filling pages to fill_factor percent. Returns DB_ALREADY_EXIST
+  // if two entries have the same key, the tree then holds the entries before them and is meant to be destroyed.
+  // Returns DB_FAILED without reading the sorter if the tree is not empty.
+  dberr_t BulkLoad(IndexKeySorter &sorter, int fill_factor = INDEX_BUILD_FILL_FACTOR);
+
   IndexIterator Begin();
 
   IndexIterator Begin(const GenericKey *key);
 
   IndexIterator End();
 
-  // expose for test purpose
+  // expose for test purpose, the leaf page is returned pinned and read latched, or nullptr if the tree is empty
   Page *FindLeafPage(const GenericKey *key, page_id_t page_id = INVALID_PAGE_ID, bool leftMost = false);
 
   // used to check whether all pages are unpinned
   bool Check();
 
-  // destroy the b plus tree
+  // destroy the b plus tree, deleting all of its pages
   void Destroy(page_id_t current_page_id = INVALID_PAGE_ID);
 
+  // debug only, not safe while the tree is modified
   void PrintTree(std::ofstream &out, Schema *schema) {
     if (IsEmpty()) {
       return;
@@ -68,30 +86,83 @@ class BPlusTree {
   }
 
  private:
+  /** Operation a descent is done for, decides which pages are safe */
+  enum class Operation { kFind, kInsert, kRemove };
+
+  /**
+   * Pages write latched by a pessimistic insert or remove, root to leaf. A nullptr entry stands for root_latch_.
+   * siblings_[i] is the sibling of latched_pages_[i] a remove may borrow from or merge with, or nullptr.
+   * Pages emptied by the operation are deleted once all latches are released.
+   */
+  struct LatchContext {
+    std::vector<Page *> latched_pages_;
+    std::vector<Page *> siblings_;
+    std::vector<page_id_t> deleted_pages_;
+  };
+
+  /**
+   * Descend to the leaf of key with read latches and write latch the leaf.
+   * @return the pinned and write latched leaf page, or nullptr if the tree is empty or the leaf is not safe for the
+   * operation, in which case nothing is left latched
+   */
+  Page *FindLeafPageOptimistic(const GenericKey *key, Operation operation);
+
+  /**
+   * Descend to the leaf of key with write latches, the caller holds root_latch_ for writing and put nullptr into
+   * the latch context. Latched pages are released as soon as a page below them is safe.
+   * @return the pinned and write latched leaf page
+   */
+  Page *FindLeafPagePessimistic(const GenericKey *key, Operation operation, LatchContext &context);
+
+  /** @return true if the operation cannot split or underflow the page */
+  bool IsSafe(BPlusTreePage *node, Operation operation) const;
+
+  /** Release all latches and pins of the context except the last page, which has become safe */
+  void ReleaseAncestors(LatchContext &context);
+
+  /** Release all latches and pins of the context, then delete the pages emptied by the operation */
+  void ReleaseLatches(LatchContext &context);
+
+  /** Fetch a page and write latch it */
+  Page *FetchAndWLatch(page_id_t page_id);
+
+  /** @return the position of a page in the latch context, its parent is the entry before */
+  size_t FindLatched(const BPlusTreePage *node, const LatchContext &context) const;
+
   void StartNewTree(GenericKey *key, const RowId &value);
 
-  bool InsertIntoLeaf(GenericKey *key, const RowId &value, Txn *transaction = nullptr);
+  /**
+   * Build one internal level of a bulk load over the pages of the level below.
+   * @param keys first key of every page of the level below, replaced by the first keys of the new level
+   * @param pages the pages of the level below, replaced by the pages of the new level
+   */
+  void BulkLoadInternalLevel(std::vector<char> &keys, std::vector<page_id_t> &pages, int fill_factor);
 
-  void InsertIntoParent(BPlusTreePage *old_node, GenericKey *key, BPlusTreePage *new_node, Txn *transaction = nullptr);
+  void InsertIntoParent(BPlusTreePage *old_node, GenericKey *key, BPlusTreePage *new_node, LatchContext &context);
 
-  LeafPage *Split(LeafPage *node, Txn *transaction);
+  // both return the new page pinned
+  LeafPage *Split(LeafPage *node);
 
-  InternalPage *Split(InternalPage *node, Txn *transaction);
+  InternalPage *Split(InternalPage *node);
 
   template <typename N>
-  bool CoalesceOrRedistribute(N *&node, Txn *transaction = nullptr);
+  void CoalesceOrRedistribute(N *node, LatchContext &context);
+
+  /** @return max size of the page the two siblings would be merged into */
+  int GetMergedMaxSize(LeafPage *left, LeafPage *right) const;
+
+  int GetMergedMaxSize(InternalPage *left, InternalPage *right) const;
 
-  bool Coalesce(InternalPage *&neighbor_node, InternalPage *&node, InternalPage *&parent, int index,
-                Txn *transaction = nullptr);
+  void Coalesce(InternalPage *neighbor_node, InternalPage *node, InternalPage *parent, int index,
+                LatchContext &context);
 
-  bool Coalesce(LeafPage *&neighbor_node, LeafPage *&node, InternalPage *&parent, int index,
-                Txn *transaction = nullptr);
+  void Coalesce(LeafPage *neighbor_node, LeafPage *node, InternalPage *parent, int index, LatchContext &context);
 
-  void Redistribute(LeafPage *neighbor_node, LeafPage *node, int index);
+  void Redistribute(LeafPage *neighbor_node, LeafPage *node, InternalPage *parent, int index);
 
-  void Redistribute(InternalPage *neighbor_node, InternalPage *node, int index);
+  void Redistribute(InternalPage *neighbor_node, InternalPage *node, InternalPage *parent, int index);
 
-  bool AdjustRoot(BPlusTreePage *node);
+  bool AdjustRoot(BPlusTreePage *node, LatchContext &context);
 
   void UpdateRootPageId(int insert_record = 0);
 
@@ -103,10 +174,13 @@ class BPlusTree {
   // member variable
   index_id_t index_id_;
   page_id_t root_page_id_{INVALID_PAGE_ID};
+  // protects root_page_id_
+  mutable ReaderWriterLatch root_latch_;
   BufferPoolManager *buffer_pool_manager_;
   KeyManager processor_;
   int leaf_max_size_;
   int internal_max_size_;
+  int internal_key_length_;  // bytes of a key stored in internal pages
 };
 
 #endif  // MINISQL_B_PLUS_TREE_H
@@ -5,16 +5,66 @@
 #include "index/generic_key.h"
 #include "index/index.h"
 
+/**
+ * BPlusTreeRangeScan reads its range in batches of INDEX_SCAN_BATCH_SIZE entries. No latch is held between two
+ * batches: the next batch descends the tree again from the last key read, so writers are never blocked by an open
+ * scan and an entry is never returned twice.
+ */
+class BPlusTreeRangeScan : public IndexRangeScan {
+ public:
+  /**
+   * Take over the bound keys, low and high may be null for an open range. Entries are compared to high on their
+   * first high_size bytes, so that high may bound a prefix of the key columns.
+   */
+  BPlusTreeRangeScan(const KeyManager &KM, BPlusTree &container, Schema *key_schema, GenericKey *low,
+                     bool low_inclusive, GenericKey *high, uint32_t high_size, bool high_inclusive);
+
+  ~BPlusTreeRangeScan() override;
+
+  DISALLOW_COPY(BPlusTreeRangeScan)
+
+  bool Next(RowId &row_id) override;
+
+  bool Next(RowId &row_id, Row &key) override;
+
+ private:
+  /** Read the next batch of row ids, starting after low_ */
+  void ReadBatch();
+
+  const KeyManager &processor_;
+  BPlusTree &container_;
+  Schema *key_schema_;
+  GenericKey *low_;     // where the next batch starts, the last key read once a batch is done
+  bool low_inclusive_;
+  GenericKey *high_;
+  uint32_t high_size_;
+  bool high_inclusive_;
+  std::vector<RowId> batch_;
+  std::vector<char> batch_keys_;  // the keys of the batch, GetKeySize() bytes each
+  size_t cursor_{0};
+  bool exhausted_{false};  // true once the last batch has been read
+};
+
 class BPlusTreeIndex : public Index {
  public:
-  BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, size_t key_size, BufferPoolManager *buffer_pool_manager);
+  BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, size_t key_size, BufferPoolManager *buffer_pool_manager,
+                 bool unique = true);
 
   dberr_t InsertEntry(const Row &key, RowId row_id, Txn *txn) override;
 
   dberr_t RemoveEntry(const Row &key, RowId row_id, Txn *txn) override;
 
+  /**
+   * Collect the rows whose key compares to the given key by compare_operator, in key order. A non-unique index
+   * returns every row with a matching key.
+   */
   dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Txn *txn, string compare_operator = "=") override;
 
+  std::unique_ptr<IndexRangeScan> ScanRange(const Row *low, bool low_inclusive, const Row *high, bool high_inclusive,
+                                            Txn *txn) override;
+
+  dberr_t BulkLoad(TableHeap *table_heap, Schema *table_schema, Txn *txn) override;
+
   dberr_t Destroy() override;
 
   IndexIterator GetBeginIterator();
@@ -1,11 +1,54 @@
 #ifndef MINISQL_GENERIC_KEY_H
 #define MINISQL_GENERIC_KEY_H
 
+#include <cstdint>
 #include <cstring>
 
 #include "record/field.h"
 #include "record/row.h"
 
+/**
+ * Compare two keys of KeySize bytes like memcmp does, one big-endian machine word at a time.
+ */
+template <size_t KeySize>
+inline int CompareFixedKeys(const char *lhs, const char *rhs) {
+  static_assert(KeySize % sizeof(uint64_t) == 0, "Fixed keys are a multiple of 8 bytes.");
+  for (size_t i = 0; i < KeySize; i += sizeof(uint64_t)) {
+    uint64_t l, r;
+    memcpy(&l, lhs + i, sizeof(uint64_t));
+    memcpy(&r, rhs + i, sizeof(uint64_t));
+    if (l != r) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+      l = __builtin_bswap64(l);
+      r = __builtin_bswap64(r);
+#endif
+      return l < r ? -1 : 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * GenericKey holds an index key in an order preserving binary encoding, so that two keys compare like their rows
+ * with a single memcmp and without deserializing them.
+ *
+ * Key format (columns in key schema order, unused bytes up to the key size are zero):
+ * -------------------------------------------------------
+ * | Null Flag-1 (1) | Column-1 | ... | Null Flag-N (1) | Column-N |
+ * -------------------------------------------------------
+ *  - Null flag: 0 for NULL (the column bytes are then all zero, NULL sorts first), 1 otherwise
+ *  - int: big-endian with the sign bit flipped (4)
+ *  - float: big-endian IEEE bits, sign bit flipped for positives and all bits flipped for negatives (4), -0.0 is
+ *    stored as 0.0 and every NaN as the same quiet NaN
+ *  - char(n): data zero padded to n bytes (n), then the big-endian length (4). A search value longer than n keeps only
+ *    its first n bytes but its whole length, so it still sorts in its place and equals no stored value.
+ *
+ * Keys of a non-unique index are followed by the RowId of their row, so that equal columns are ordered by row and
+ * every entry of the tree stays unique:
+ *  - RowId: big-endian page id with the sign bit flipped (4), then the big-endian slot number (4)
+ *
+ * A row with only the leading columns of the key schema encodes to a prefix of the key, which bounds a range scan.
+ */
 class GenericKey {
   friend class KeyManager;
 public:
@@ -18,57 +61,103 @@ class KeyManager {
     return (GenericKey *)malloc(key_size_);  // remember delete
   }
 
-  inline void SerializeFromKey(GenericKey *key_buf, const Row &key, Schema *schema) const {
-    // initialize to 0
-    [[maybe_unused]] uint32_t size = key.GetSerializedSize(schema);
-    ASSERT(key.GetFieldCount() == schema->GetColumnCount(), "field nums not match.");
-    ASSERT(size <= (uint32_t)key_size_, "Index key size exceed max key size.");
-    memset(key_buf->data, 0, key_size_);
-    key.SerializeTo(key_buf->data, schema);
-  }
+  /** The row may hold only the leading columns of the schema, the remaining bytes of the key are zero. */
+  void SerializeFromKey(GenericKey *key_buf, const Row &key, Schema *schema) const;
 
-  inline void DeserializeToKey(const GenericKey *key_buf, Row &key, Schema *schema) const {
-    [[maybe_unused]] uint32_t ofs = key.DeserializeFrom(const_cast<char *>(key_buf->data), schema);
-    ASSERT(ofs <= (uint32_t)key_size_, "Index key size exceed max key size.");
-  }
+  void DeserializeToKey(const GenericKey *key_buf, Row &key, Schema *schema) const;
+
+  /**
+   * Append the row id to a key of a non-unique index, does nothing for a unique index.
+   * A key fresh from SerializeFromKey has the smallest suffix and sorts before all entries with the same columns.
+   */
+  void SetKeyRowId(GenericKey *key_buf, const RowId &rid) const;
+
+  /**
+   * Fill the key after its first prefix_size bytes with the largest suffix, so that it sorts after all entries that
+   * start with the same prefix. Does nothing for a whole key of a unique index.
+   */
+  void SetKeyUpperBound(GenericKey *key_buf, uint32_t prefix_size) const;
+
+  /**
+   * @return number of bytes taken by the first column_count columns of a key
+   */
+  uint32_t GetPrefixSize(uint32_t column_count) const;
 
   // compare
   [[nodiscard]] inline int CompareKeys(const GenericKey *lhs, const GenericKey *rhs) const {
-    //    ASSERT(malloc_usable_size((void *)&lhs) == malloc_usable_size((void *)&rhs), "key size not match.");
-    uint32_t column_count = key_schema_->GetColumnCount();
-    Row lhs_key(INVALID_ROWID);
-    Row rhs_key(INVALID_ROWID);
-    DeserializeToKey(lhs, lhs_key, key_schema_);
-    DeserializeToKey(rhs, rhs_key, key_schema_);
-
-    for (uint32_t i = 0; i < column_count; i++) {
-      Field *lhs_value = lhs_key.GetField(i);
-      Field *rhs_value = rhs_key.GetField(i);
-
-      if (lhs_value->CompareLessThan(*rhs_value) == CmpBool::kTrue) {
-        return -1;
-      }
-
-      if (lhs_value->CompareGreaterThan(*rhs_value) == CmpBool::kTrue) {
-        return 1;
-      }
+    switch (fixed_key_size_) {
+      case 8:
+        return CompareFixedKeys<8>(lhs->data, rhs->data);
+      case 16:
+        return CompareFixedKeys<16>(lhs->data, rhs->data);
+      case 32:
+        return CompareFixedKeys<32>(lhs->data, rhs->data);
+      case 64:
+        return CompareFixedKeys<64>(lhs->data, rhs->data);
+      default:
+        return memcmp(lhs->data, rhs->data, encoded_size_);
     }
-    // equals
-    return 0;
+  }
+
+  /**
+   * Compare the first prefix_size bytes of two keys, e.g. the key columns without the row id of a non-unique index.
+   */
+  [[nodiscard]] inline int CompareKeyPrefix(const GenericKey *lhs, const GenericKey *rhs, uint32_t prefix_size) const {
+    return memcmp(lhs->data, rhs->data, prefix_size);
   }
 
   inline int GetKeySize() const { return key_size_; }
 
+  /**
+   * @return number of leading bytes of a key that are compared, the rest of the key is zero padding
+   */
+  inline int GetEncodedKeySize() const { return static_cast<int>(encoded_size_); }
+
+  /**
+   * @return false if the keys carry the row id as a suffix
+   */
+  inline bool IsUnique() const { return unique_; }
+
+  /**
+   * @return the key size if keys are compared by a fixed width comparator (8, 16, 32 or 64 bytes), 0 otherwise
+   */
+  inline int GetFixedKeySize() const { return fixed_key_size_; }
+
+  /**
+   * @return number of bytes needed to encode a key of the given schema
+   */
+  static uint32_t GetEncodedSize(Schema *key_schema);
+
+  static constexpr uint32_t ROW_ID_ENCODED_SIZE = 8;
+
   KeyManager(const KeyManager &other) {
     this->key_schema_ = other.key_schema_;
     this->key_size_ = other.key_size_;
+    this->encoded_size_ = other.encoded_size_;
+    this->column_size_ = other.column_size_;
+    this->unique_ = other.unique_;
+    this->fixed_key_size_ = other.fixed_key_size_;
   }
 
   // constructor
-  KeyManager(Schema *key_schema, size_t key_size) : key_size_(key_size), key_schema_(key_schema) {}
+  KeyManager(Schema *key_schema, size_t key_size, bool unique = true)
+      : key_size_(key_size), unique_(unique), key_schema_(key_schema) {
+    uint32_t row_id_size = unique_ ? 0 : ROW_ID_ENCODED_SIZE;
+    column_size_ = key_schema_ == nullptr ? key_size_ - row_id_size : GetEncodedSize(key_schema_);
+    encoded_size_ = column_size_ + row_id_size;
+    ASSERT(encoded_size_ <= (uint32_t)key_size_, "Index key size exceed max key size.");
+    // the padding of a key is zero, so keys of these sizes can be compared whole
+    if (key_size_ == 8 || key_size_ == 16 || key_size_ == 32 || key_size_ == 64) {
+      fixed_key_size_ = key_size_;
+    }
+  }
 
  private:
   int key_size_;
+  uint32_t encoded_size_;  // prefix of the key compared by CompareKeys
+  uint32_t column_size_;   // prefix of the key holding the columns, the row id follows for a non-unique index
+  bool unique_{true};
+  int fixed_key_size_{0};  // key size of the fixed width comparator, 0 for memcmp over encoded_size_
   Schema *key_schema_;
 };
 
@@ -7,9 +7,27 @@
 #include "concurrency/txn.h"
 #include "record/row.h"
 
+class TableHeap;
+
+/**
+ * IndexRangeScan walks the rows of an index whose key lies between two bounds, in key order. Rows are produced on
+ * demand, so a consumer that stops early only pays for what it has read.
+ */
+class IndexRangeScan {
+ public:
+  virtual ~IndexRangeScan() = default;
+
+  /** Move to the next row of the range, @return false once the range is exhausted */
+  virtual bool Next(RowId &row_id) = 0;
+
+  /** Same as Next, and also decode the key columns of the entry into key, which must be an empty row */
+  virtual bool Next(RowId &row_id, Row &key) = 0;
+};
+
 class Index {
  public:
-  explicit Index(index_id_t index_id, IndexSchema *key_schema) : index_id_(index_id), key_schema_(key_schema) {}
+  explicit Index(index_id_t index_id, IndexSchema *key_schema, bool unique = true)
+      : index_id_(index_id), key_schema_(key_schema), unique_(unique) {}
 
   virtual ~Index() {}
 
@@ -19,11 +37,26 @@ class Index {
 
   virtual dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Txn *txn, string compare_operator = "=") = 0;
 
+  /**
+   * Start a scan over the keys between low and high, a null bound leaves that side of the range open.
+   * A bound may hold only the leading key columns, it is then compared to the same columns of the keys.
+   * The scan must not outlive the index.
+   */
+  virtual std::unique_ptr<IndexRangeScan> ScanRange(const Row *low, bool low_inclusive, const Row *high,
+                                                    bool high_inclusive, Txn *txn) = 0;
+
+  /** Fill a new index with the rows of its table, table_schema is the schema of the rows in table_heap */
+  virtual dberr_t BulkLoad(TableHeap *table_heap, Schema *table_schema, Txn *txn) = 0;
+
   virtual dberr_t Destroy() = 0;
 
+  /** @return false if several rows may have the same key */
+  inline bool IsUnique() const { return unique_; }
+
  protected:
   index_id_t index_id_;
   IndexSchema *key_schema_;
+  bool unique_;
 };
 
 #endif  // MINISQL_INDEX_H
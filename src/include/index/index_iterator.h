@@ -3,6 +3,12 @@
 
 #include "page/b_plus_tree_leaf_page.h"
 
+/**
+ * The iterator holds a pin and a read latch on its current leaf. It moves to the next leaf with latch coupling: the
+ * next leaf is latched before the current one is released, so writers never see it between two leaves.
+ * An iterator must not outlive the tree operation of its thread, and a thread must not modify the tree while it holds
+ * an iterator.
+ */
 class IndexIterator {
   using LeafPage = BPlusTreeLeafPage;
 
@@ -10,7 +16,16 @@ class IndexIterator {
   // you may define your own constructor based on your member variables
   explicit IndexIterator();
 
-  explicit IndexIterator(page_id_t page_id, BufferPoolManager *bpm, int index = 0);
+  /** Take over a pinned and read latched leaf page. */
+  explicit IndexIterator(Page *page, BufferPoolManager *bpm, int index = 0);
+
+  IndexIterator(IndexIterator &&other) noexcept;
+
+  IndexIterator &operator=(IndexIterator &&other) noexcept;
+
+  IndexIterator(const IndexIterator &) = delete;
+
+  IndexIterator &operator=(const IndexIterator &) = delete;
 
   ~IndexIterator();
 
@@ -27,11 +42,18 @@ class IndexIterator {
   bool operator!=(const IndexIterator &itr) const;
 
  private:
+  /** Move on through the leaf chain until item_index points at an item, or to the end. */
+  void SkipToItem();
+
+  /** Unlatch and unpin the current leaf and become the end iterator. */
+  void Release();
+
   page_id_t current_page_id{INVALID_PAGE_ID};
+  Page *current_page{nullptr};
   LeafPage *page{nullptr};
   int item_index{0};
   BufferPoolManager *buffer_pool_manager{nullptr};
-  // add your own private member variables here
+  GenericKey *key{nullptr};  // the current key, leaves store keys without their common prefix
 };
 
 #endif  // MINISQL_INDEX_ITERATOR_H
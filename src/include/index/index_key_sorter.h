@@ -0,0 +1,79 @@
+#ifndef MINISQL_INDEX_KEY_SORTER_H
+#define MINISQL_INDEX_KEY_SORTER_H
+
+#include <cstdio>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "common/rowid.h"
+#include "index/generic_key.h"
+
+/**
+ * IndexKeySorter sorts the (key, RowId) entries of an index build by key and then by RowId.
+ *
+ * Entries are buffered in memory up to memory_limit bytes. Beyond that, every full buffer is sorted and spilled as a
+ * run into a temporary file, and the runs are merged while the entries are read back. Since keys are encoded to be
+ * memcmp comparable, sorting never has to deserialize a key.
+ *
+ * Usage: Add() all entries, call Sort() once, then Next() until it returns false.
+ */
+class IndexKeySorter {
+ public:
+  explicit IndexKeySorter(const KeyManager &KM, size_t memory_limit = INDEX_SORT_MEMORY);
+
+  ~IndexKeySorter();
+
+  DISALLOW_COPY(IndexKeySorter)
+
+  void Add(const GenericKey *key, RowId rid);
+
+  /** Finish adding entries and prepare reading them in order. */
+  void Sort();
+
+  /**
+   * Read the next entry in order.
+   * @param key set to the key of the entry, valid until the next call
+   * @return false once all entries have been read
+   */
+  bool Next(GenericKey *&key, RowId &rid);
+
+  /** @return the number of entries added */
+  inline size_t GetEntryCount() const { return entry_count_; }
+
+ private:
+  /** A sorted run spilled to a temporary file, with its current entry while merging. */
+  struct Run {
+    FILE *file_;
+    std::vector<char> current_;
+  };
+
+  /** @return true if entry lhs goes before entry rhs */
+  bool Less(const char *lhs, const char *rhs) const;
+
+  /** @return true if the current entry of run lhs goes after the one of run rhs, orders heap_ */
+  bool RunGreater(size_t lhs, size_t rhs) const;
+
+  /** Sort the buffered entries into sorted_. */
+  void SortBuffer();
+
+  /** Write the buffered entries to a new run and empty the buffer. */
+  void SpillRun();
+
+  /** Read the next entry of a run into its current_, @return false at the end of the run, throws on a read error */
+  bool ReadRun(Run &run);
+
+  const KeyManager &key_manager_;
+  size_t key_size_;
+  size_t entry_size_;  // key followed by the RowId
+  size_t memory_limit_;
+  size_t entry_count_{0};
+  std::vector<char> buffer_;         // unsorted entries in memory
+  std::vector<const char *> sorted_;  // entries of buffer_ in order
+  size_t next_sorted_{0};
+  std::vector<Run> runs_;
+  std::vector<size_t> heap_;  // runs that still have entries, as a min heap on their current entry
+  std::vector<char> entry_;   // entry last returned by Next() while merging
+};
+
+#endif  // MINISQL_INDEX_KEY_SORTER_H
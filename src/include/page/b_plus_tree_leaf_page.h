@@ -6,20 +6,30 @@
  *
  * Store indexed key and record id(record id = page id combined with slot id,
  * see include/common/rid.h for detailed implementation) together within leaf
- * page. Only support unique key.
-
+ * page. Keys within the tree are unique: the key of a non-unique index ends with the RowId of its row (see
+ * generic_key.h), so entries with equal columns are distinct keys ordered by row.
+ *
+ * Every leaf covers the key range [LowKey, HighKey) given by its fences, -inf is a key of zero bytes and +inf a key
+ * of 0xff bytes. All keys of the range start with the common prefix of the two fences, so a leaf stores only the rest
+ * of each key, and only up to the key length: the zero padding of a key is never stored. The prefix changes only
+ * when the fences do, i.e. on split, merge and redistribution, and the max size of the page changes with it.
+ * Leaves of 8 byte keys are not compressed, their keys are searched as machine words (see SearchWordKeys).
+ *
  * Leaf page format (keys are stored in order):
- *  ----------------------------------------------------------------------
- * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
- *  ----------------------------------------------------------------------
+ *  ---------------------------------------------------------------------------------------------------
+ * | HEADER | LowKey | HighKey | SUFFIX(1) + RID(1) | SUFFIX(2) + RID(2) | ... | SUFFIX(n) + RID(n)
+ *  ---------------------------------------------------------------------------------------------------
  *
- *  Header format (size in byte, 24 bytes in total):
+ *  Header format (size in byte, 44 bytes in total):
  *  ---------------------------------------------------------------------
- * | PageType (4) | CurrentSize (4) | MaxSize (4) | ParentPageId (4) |
+ * | PageType (4) | KeySize (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
  *  ---------------------------------------------------------------------
- *  ------------------------------
- * | PageId (4) | NextPageId (4)
- *  ------------------------------
+ *  ------------------------------------------------------------------------------------
+ * | ParentPageId (4) | PageId (4) | NextPageId (4) | KeyLength (4) | PrefixSize (4) |
+ *  ------------------------------------------------------------------------------------
+ *  ------------------
+ * | SizeLimit (4) |
+ *  ------------------
  */
 #include <utility>
 #include <vector>
@@ -27,44 +37,70 @@
 #include "index/generic_key.h"
 #include "page/b_plus_tree_page.h"
 
-#define LEAF_PAGE_HEADER_SIZE 32
+#define LEAF_PAGE_HEADER_SIZE 44
 
 class BPlusTreeLeafPage : public BPlusTreePage {
  public:
   // After creating a new leaf page from buffer pool, must call initialize
-  // method to set default values
+  // method to set default values. The page covers all keys, key_length is the number of bytes of a key that are
+  // compared (see KeyManager::GetEncodedKeySize), max_size only limits the max size given by the page capacity.
   void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int key_size = UNDEFINED_SIZE,
-            int max_size = UNDEFINED_SIZE);
+            int max_size = UNDEFINED_SIZE, int key_length = UNDEFINED_SIZE);
 
   // helper methods
   page_id_t GetNextPageId() const;
 
   void SetNextPageId(page_id_t next_page_id);
 
-  GenericKey *KeyAt(int index);
+  /**
+   * A leaf underflows below half of the max size of its uncompressed layout, so that the halves of a split, whose
+   * prefix may have grown, never underflow. Hides BPlusTreePage::GetMinSize.
+   */
+  int GetMinSize() const;
 
-  void SetKeyAt(int index, GenericKey *key);
+  /** @return max size of the page if its high key were high_key, its keys must all be below high_key */
+  int GetMaxSizeUpTo(const GenericKey *high_key) const;
 
-  RowId ValueAt(int index) const;
+  /** @return max size of a page covering the key ranges of this page and of its right sibling */
+  int GetMergedMaxSize(const BPlusTreeLeafPage *right) const;
 
-  void SetValueAt(int index, RowId value);
+  /** Copy the low key of the page into key, the separator of the page in its parent unless it is the leftmost leaf. */
+  void GetLowKey(GenericKey *key) const;
+
+  /**
+   * Move the fences of the page and lay out its keys for the new prefix.
+   * All keys of the page must be within the new range, and the page must not exceed its new max size.
+   */
+  void SetKeyRange(const GenericKey *low_key, const GenericKey *high_key);
 
-  int KeyIndex(const GenericKey *key, const KeyManager &comparator);
+  void SetHighKey(const GenericKey *high_key);
 
-  void *PairPtrAt(int index);
+  /** Copy the key at index into key, the page stores only part of it. */
+  void KeyAt(int index, GenericKey *key) const;
 
-  void PairCopy(void *dest, void *src, int pair_num = 1);
+  /** Store a key at index, it must be within the key range of the page. */
+  void SetKeyAt(int index, const GenericKey *key);
+
+  /** Compare the key at index with key, like KeyManager::CompareKeys. */
+  int CompareKeyAt(int index, const GenericKey *key) const;
+
+  RowId ValueAt(int index) const;
+
+  void SetValueAt(int index, RowId value);
 
-  std::pair<GenericKey *, RowId> GetItem(int index);
+  int KeyIndex(const GenericKey *key, const KeyManager &comparator) const;
+
+  /** Copy the key at index into key and return it with its value. */
+  std::pair<GenericKey *, RowId> GetItem(int index, GenericKey *key) const;
 
   // insert and delete methods
   int Insert(GenericKey *key, const RowId &value, const KeyManager &comparator);
 
-  bool Lookup(const GenericKey *key, RowId &value, const KeyManager &comparator);
+  bool Lookup(const GenericKey *key, RowId &value, const KeyManager &comparator) const;
 
   int RemoveAndDeleteRecord(const GenericKey *key, const KeyManager &comparator);
 
-  // Split and Merge utility methods
+  // Split and Merge utility methods, they move the fences of both pages
   void MoveHalfTo(BPlusTreeLeafPage *recipient);
 
   void MoveAllTo(BPlusTreeLeafPage *recipient);
@@ -74,13 +110,38 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
 
  private:
-  void CopyNFrom(void *src, int size);
+  inline char *LowFence() { return data_; }
+
+  inline const char *LowFence() const { return data_; }
+
+  inline char *HighFence() { return data_ + key_length_; }
+
+  inline const char *HighFence() const { return data_ + key_length_; }
+
+  inline int PairSize() const { return key_length_ - prefix_size_ + static_cast<int>(sizeof(RowId)); }
+
+  inline char *PairAt(int index) { return data_ + 2 * key_length_ + index * PairSize(); }
+
+  inline const char *PairAt(int index) const { return data_ + 2 * key_length_ + index * PairSize(); }
+
+  /** @return number of key bytes shared by all keys between the two fences */
+  int CommonPrefixSize(const char *low, const char *high) const;
+
+  /** @return max size of the page for a prefix of prefix_size bytes */
+  int MaxSizeFor(int prefix_size) const;
+
+  /** Copy the first key_length_ bytes of the key at index into key. */
+  void CopyKeyAt(int index, char *key) const;
 
-  void CopyLastFrom(GenericKey *key, const RowId value);
+  /** Copy a key & value pair of src into the pair at index, converting it to the prefix of this page. */
+  void CopyPairFrom(const BPlusTreeLeafPage *src, int src_index, int index);
 
-  void CopyFirstFrom(GenericKey *key, const RowId value);
+  void CopyNFrom(const BPlusTreeLeafPage *src, int src_index, int size);
 
   page_id_t next_page_id_{INVALID_PAGE_ID};
+  int key_length_;   // bytes of a key that are stored
+  int prefix_size_;  // bytes of a key that are shared by the fences and left out of every pair
+  int size_limit_;   // upper bound of the max size, UNDEFINED_SIZE if the capacity of the page decides
 
   char data_[PAGE_SIZE - LEAF_PAGE_HEADER_SIZE];
 };
@@ -7,6 +7,7 @@
 #include <string>
 
 #include "buffer/buffer_pool_manager.h"
+#include "index/generic_key.h"
 
 // define page type enum
 enum class IndexPageType { INVALID_INDEX_PAGE = 0, LEAF_PAGE, INTERNAL_PAGE };
@@ -59,6 +60,58 @@ class BPlusTreePage {
 
   void SetLSN(lsn_t lsn = INVALID_LSN);
 
+ protected:
+  /**
+   * Binary search over an array of size key & value pairs with keys of KeySize bytes, so that the stride and the key
+   * comparison are known at compile time.
+   * @return index of the first key >= key, or of the first key > key if upper is true
+   */
+  template <size_t KeySize, size_t ValueSize>
+  static int FixedKeySearch(const char *pairs, int size, const GenericKey *key, bool upper) {
+    constexpr size_t pair_size = KeySize + ValueSize;
+    if constexpr (KeySize == sizeof(uint64_t)) {
+      return SearchWordKeys(pairs, pair_size, size, key, upper);
+    }
+    int left = 0;
+    int right = size;
+    while (left < right) {
+      int mid = (left + right) / 2;
+      int cmp = CompareFixedKeys<KeySize>(pairs + mid * pair_size, key->data);
+      if (cmp < 0 || (upper && cmp == 0)) {
+        left = mid + 1;
+      } else {
+        right = mid;
+      }
+    }
+    return left;
+  }
+
+  /**
+   * FixedKeySearch for 8 byte keys. The search range is narrowed by a binary search, then the keys left are counted
+   * with SSE4.2 compares if the CPU supports them, or with a scalar loop.
+   */
+  static int SearchWordKeys(const char *pairs, size_t pair_size, int size, const GenericKey *key, bool upper);
+
+  /**
+   * FixedKeySearch for the fixed width comparator of KM
+   * @return -1 if KM has no fixed width comparator
+   */
+  template <size_t ValueSize>
+  static int FixedKeySearch(const char *pairs, int size, const GenericKey *key, bool upper, const KeyManager &KM) {
+    switch (KM.GetFixedKeySize()) {
+      case 8:
+        return FixedKeySearch<8, ValueSize>(pairs, size, key, upper);
+      case 16:
+        return FixedKeySearch<16, ValueSize>(pairs, size, key, upper);
+      case 32:
+        return FixedKeySearch<32, ValueSize>(pairs, size, key, upper);
+      case 64:
+        return FixedKeySearch<64, ValueSize>(pairs, size, key, upper);
+      default:
+        return -1;
+    }
+  }
+
  private:
   // member variable, attributes that both internal and leaf page share
   [[maybe_unused]] IndexPageType page_type_;
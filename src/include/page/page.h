@@ -15,7 +15,8 @@
  */
 class Page {
   // There is book-keeping information inside the page that should only be relevant to the buffer pool manager.
-  friend class BufferPoolManager;
+  friend class BufferPoolManagerInstance;
+  friend class MmapBufferPoolManager;
 
  public:
   DISALLOW_COPY(Page)
@@ -37,6 +37,11 @@ class TablePage : public Page {
 
   page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
 
+  /** @return the next page id stored in the raw data of a table page, used to follow the heap chain on prefetch */
+  static page_id_t NextPageIdOf(const char *data) {
+    return *reinterpret_cast<const page_id_t *>(data + OFFSET_NEXT_PAGE_ID);
+  }
+
   void SetPrevPageId(page_id_t prev_page_id) {
     memcpy(GetData() + OFFSET_PREV_PAGE_ID, &prev_page_id, sizeof(page_id_t));
   }
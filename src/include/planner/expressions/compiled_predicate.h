@@ -0,0 +1,90 @@
+#ifndef MINISQL_COMPILED_PREDICATE_H
+#define MINISQL_COMPILED_PREDICATE_H
+
+#include <string>
+#include <vector>
+
+#include "planner/expressions/abstract_expression.h"
+
+/**
+ * CompiledPredicate is a predicate translated once, when its plan is built, into a tree of nodes that is evaluated
+ * without building any Field. A comparison calls a function specialized for the type of its operands and its
+ * operator, instead of dispatching on the operator string and on the Type of the fields for every row.
+ *
+ * Comparisons between constants are folded, and so are AND and OR with a constant side. AND and OR skip their right
+ * side when the left one decides the result. A part of the predicate that cannot be compiled, e.g. a comparison of
+ * fields of different types, is evaluated through its expression.
+ */
+class CompiledPredicate {
+ public:
+  /** Compile a predicate made of logic expressions, comparisons, columns and constants */
+  explicit CompiledPredicate(AbstractExpressionRef predicate);
+
+  /** @return The value of the predicate on the row */
+  CmpBool Evaluate(const Row &row) const { return Run(nodes_[root_], row); }
+
+  /** @return true if the predicate is true for the row */
+  bool Matches(const Row &row) const { return Evaluate(row) == kTrue; }
+
+  /**
+   * Filter a batch of rows: narrow the selection down to the rows the predicate is true for.
+   * @param rows The rows of the batch
+   * @param[in,out] selection The positions in rows of the rows to evaluate, in increasing order
+   */
+  void Select(const std::vector<Row> &rows, std::vector<uint32_t> &selection) const;
+
+ private:
+  enum class NodeType { Constant, And, Or, Compare, IsNull, IsNotNull, Expression };
+
+  enum class CompareOp { Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual };
+
+  using CompareFunction = CmpBool (*)(const Field &lhs, const Field &rhs);
+
+  struct Node {
+    NodeType type_;
+    CmpBool value_{kNull};                         // Constant: the value
+    CompareFunction compare_{nullptr};             // Compare: the comparison of the operands
+    const Field *constants_[2]{nullptr, nullptr};  // Compare, IsNull, IsNotNull: the operands that are constants
+    uint32_t columns_[2]{0, 0};                    // Compare, IsNull, IsNotNull: the columns of the other operands
+    uint32_t children_[2]{0, 0};                   // And, Or: the nodes of the operands
+    AbstractExpression *expression_{nullptr};      // Expression: the expression evaluated
+  };
+
+  /** @return The node of the compiled expression */
+  uint32_t Compile(const AbstractExpressionRef &expr);
+
+  uint32_t AddNode(const Node &node);
+
+  uint32_t AddConstant(CmpBool value);
+
+  CmpBool Run(const Node &node, const Row &row) const;
+
+  static const Field &Operand(const Node &node, uint32_t side, const Row &row) {
+    return node.constants_[side] != nullptr ? *node.constants_[side] : *row.GetField(node.columns_[side]);
+  }
+
+  /** @return The comparison of two fields of the type, nullptr if the type cannot be compared */
+  static CompareFunction GetCompareFunction(const std::string &comp_type, TypeId type);
+
+  template <CompareOp op>
+  static CompareFunction GetCompareFunction(TypeId type);
+
+  template <CompareOp op, typename T>
+  static CmpBool Decide(T lhs, T rhs);
+
+  template <CompareOp op>
+  static CmpBool CompareInts(const Field &lhs, const Field &rhs);
+
+  template <CompareOp op>
+  static CmpBool CompareFloats(const Field &lhs, const Field &rhs);
+
+  template <CompareOp op>
+  static CmpBool CompareChars(const Field &lhs, const Field &rhs);
+
+  /** Keeps the constants the nodes point to alive */
+  AbstractExpressionRef predicate_;
+  std::vector<Node> nodes_;
+  uint32_t root_;
+};
+
+#endif  // MINISQL_COMPILED_PREDICATE_H
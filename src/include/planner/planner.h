@@ -8,8 +8,11 @@
 #include "common/instance.h"
 #include "executor/plans/abstract_plan.h"
 #include "executor/plans/delete_plan.h"
+#include "executor/plans/hash_join_plan.h"
+#include "executor/plans/index_only_scan_plan.h"
 #include "executor/plans/index_scan_plan.h"
 #include "executor/plans/insert_plan.h"
+#include "executor/plans/nested_index_join_plan.h"
 #include "executor/plans/seq_scan_plan.h"
 #include "executor/plans/update_plan.h"
 #include "executor/plans/values_plan.h"
@@ -34,6 +37,14 @@ class Planner {
 
   AbstractPlanNodeRef PlanSelect(std::shared_ptr<SelectStatement> statement);
 
+  /** Plan the scan of one table, through an index if the condition allows it */
+  AbstractPlanNodeRef PlanScan(const std::string &table_name, const Schema *out_schema,
+                               const AbstractExpressionRef &where, const std::vector<uint32_t> &column_in_condition,
+                               bool has_or);
+
+  /** Plan a select from several tables as a chain of joins */
+  AbstractPlanNodeRef PlanJoin(std::shared_ptr<SelectStatement> statement);
+
   AbstractPlanNodeRef PlanInsert(std::shared_ptr<InsertStatement> statement);
 
   AbstractPlanNodeRef PlanDelete(std::shared_ptr<DeleteStatement> statement);
@@ -34,18 +34,40 @@ class AbstractStatement {
   virtual std::string ToString() const {
     throw std::logic_error("ToString not supported for this type of SQLStatement");
   }
+  /**
+   * Split a column name that may be qualified by its table, as in table.column.
+   * @param[out] column_name The name without the table
+   * @return The name of the table, empty if the name is not qualified
+   */
+  static std::string SplitColumnName(const std::string &name, std::string &column_name) {
+    size_t dot = name.find('.');
+    if (dot == std::string::npos) {
+      column_name = name;
+      return "";
+    }
+    column_name = name.substr(dot + 1);
+    return name.substr(0, dot);
+  }
+
   /**
    * Make a column value expression.
    * @param table_name The name of the table
    * @param col The ptr to the SyntaxNode of the column
    * @return A owning pointer to the ColumnValueExpression
    */
-  AbstractExpressionRef MakeColumnValueExpression(const std::string &table_name, pSyntaxNode col) {
+  virtual AbstractExpressionRef MakeColumnValueExpression(const std::string &table_name, pSyntaxNode col) {
+    std::string column_name;
+    std::string qualifier = SplitColumnName(col->val_, column_name);
+    if (!qualifier.empty() && qualifier != table_name) {
+      std::stringstream error_info;
+      error_info << "the table " << qualifier << " is not in the statement.";
+      throw std::logic_error(error_info.str());
+    }
     TableInfo *info = nullptr;
     context_->GetCatalog()->GetTable(table_name, info);
     auto schema = info->GetSchema();
     uint32_t index;
-    if (schema->GetColumnIndex(col->val_, index) != DB_SUCCESS) {
+    if (schema->GetColumnIndex(column_name, index) != DB_SUCCESS) {
       throw std::logic_error("the column does not exist in table");
     }
     auto col_type = schema->GetColumn(index)->GetType();
@@ -112,15 +134,29 @@ class AbstractStatement {
         pSyntaxNode col = ast->child_;
         pSyntaxNode value = ast->child_->next_;
         auto col_expr = MakeColumnValueExpression(table_name, col);
-        auto const_expr = MakeConstantValueExpression(col_expr->GetReturnType(), value);
+        AbstractExpressionRef value_expr;
+        if (value->type_ == kNodeIdentifier) {
+          // a comparison between two columns
+          value_expr = MakeColumnValueExpression(table_name, value);
+          if (value_expr->GetReturnType() != col_expr->GetReturnType()) {
+            throw std::logic_error("The columns compared in the predicate have different types");
+          }
+        } else {
+          value_expr = MakeConstantValueExpression(col_expr->GetReturnType(), value);
+        }
         if (column_in_condition) {
-          uint32_t index = dynamic_pointer_cast<ColumnValueExpression>(col_expr)->GetColIdx();
-          if (std::find(column_in_condition->begin(), column_in_condition->end(), index) ==
-              column_in_condition->end()) {
-            column_in_condition->emplace_back(index);
+          for (const auto &expr : {col_expr, value_expr}) {
+            if (expr->GetType() != ExpressionType::ColumnExpression) {
+              continue;
+            }
+            uint32_t index = dynamic_pointer_cast<ColumnValueExpression>(expr)->GetColIdx();
+            if (std::find(column_in_condition->begin(), column_in_condition->end(), index) ==
+                column_in_condition->end()) {
+              column_in_condition->emplace_back(index);
+            }
           }
         }
-        return MakeComparisonExpression(col_expr, const_expr, ast->val_);
+        return MakeComparisonExpression(col_expr, value_expr, ast->val_);
       }
       default:
         throw std::logic_error("The node kNodeConditions has a child node of the wrong type");
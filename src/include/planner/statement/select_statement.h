@@ -23,7 +23,15 @@ class SelectStatement : public AbstractStatement {
           error_info << "the table " << ast->val_ << " is not exist.";
           throw std::logic_error(error_info.str());
         }
-        table_name_ = ast->val_;
+        if (std::find(table_names_.begin(), table_names_.end(), ast->val_) != table_names_.end()) {
+          std::stringstream error_info;
+          error_info << "the table " << ast->val_ << " is selected twice.";
+          throw std::logic_error(error_info.str());
+        }
+        if (table_names_.empty()) {
+          table_name_ = ast->val_;
+        }
+        table_names_.emplace_back(ast->val_);
         break;
       }
       case kNodeAllColumns:
@@ -43,31 +51,70 @@ class SelectStatement : public AbstractStatement {
   };
 
   void MakeColumnList(pSyntaxNode ast) {
-    TableInfo *info = nullptr;
-    context_->GetCatalog()->GetTable(table_name_, info);
-    auto schema = info->GetSchema();
     if (!ast) {
-      auto columns = schema->GetColumns();
-      for (auto column : columns) {
-        auto expr = std::make_shared<ColumnValueExpression>(0, column->GetTableInd(), column->GetType());
-        column_list_.emplace_back(make_pair(column->GetName(), expr));
+      uint32_t offset = 0;
+      for (const auto &table_name : table_names_) {
+        TableInfo *info = nullptr;
+        context_->GetCatalog()->GetTable(table_name, info);
+        for (auto column : info->GetSchema()->GetColumns()) {
+          auto expr =
+              std::make_shared<ColumnValueExpression>(0, offset + column->GetTableInd(), column->GetType());
+          column_list_.emplace_back(make_pair(column->GetName(), expr));
+        }
+        offset += info->GetSchema()->GetColumnCount();
       }
     } else {
       while (ast) {
-        uint32_t index;
-        if (schema->GetColumnIndex(ast->val_, index) != DB_SUCCESS) {
-          throw std::logic_error("the column does not exist in table");
-        }
-        auto expr = std::make_shared<ColumnValueExpression>(0, index, schema->GetColumn(index)->GetType());
-        column_list_.emplace_back(make_pair(ast->val_, expr));
+        column_list_.emplace_back(make_pair(ast->val_, MakeColumnValueExpression(table_name_, ast)));
         ast = ast->next_;
       }
     }
   }
 
-  /** Bound FROM clause. */
+  /**
+   * With several tables in FROM, a column is bound to its index in the joined row, made of the columns of all the
+   * tables in FROM order. Its name must then be unique among those tables, unless it is qualified by its table.
+   */
+  AbstractExpressionRef MakeColumnValueExpression(const std::string &table_name, pSyntaxNode col) override {
+    if (table_names_.size() < 2) {
+      return AbstractStatement::MakeColumnValueExpression(table_name, col);
+    }
+    std::string column_name;
+    std::string qualifier = SplitColumnName(col->val_, column_name);
+    if (!qualifier.empty() && std::find(table_names_.begin(), table_names_.end(), qualifier) == table_names_.end()) {
+      std::stringstream error_info;
+      error_info << "the table " << qualifier << " is not in the statement.";
+      throw std::logic_error(error_info.str());
+    }
+    AbstractExpressionRef expr = nullptr;
+    uint32_t offset = 0;
+    for (const auto &name : table_names_) {
+      TableInfo *info = nullptr;
+      context_->GetCatalog()->GetTable(name, info);
+      auto schema = info->GetSchema();
+      uint32_t index;
+      if ((qualifier.empty() || qualifier == name) && schema->GetColumnIndex(column_name, index) == DB_SUCCESS) {
+        if (expr != nullptr) {
+          std::stringstream error_info;
+          error_info << "the column " << col->val_ << " is ambiguous.";
+          throw std::logic_error(error_info.str());
+        }
+        expr = std::make_shared<ColumnValueExpression>(0, offset + index, schema->GetColumn(index)->GetType());
+      }
+      offset += schema->GetColumnCount();
+    }
+    if (expr == nullptr) {
+      throw std::logic_error("the column does not exist in table");
+    }
+    return expr;
+  }
+
+  /** Bound FROM clause, the first table when there are several. */
   std::string table_name_;
 
+  /** The tables of FROM in order, joined if there are several. */
+  std::vector<std::string> table_names_;
+
   /** Bound SELECT list. */
   std::vector<std::pair<std::string, AbstractExpressionRef>> column_list_;
 
@@ -82,7 +129,11 @@ class SelectStatement : public AbstractStatement {
 
   std::string ToString() const override {
     std::stringstream sstream;
-    sstream << "Select {{\\n  table={" << table_name_ << "},\\n  columns={";
+    sstream << "Select {{\\n  tables={";
+    for (const auto &table_name : table_names_) {
+      sstream << table_name << " ";
+    }
+    sstream << "},\\n  columns={";
     for (const auto &column_pair : column_list_) {
       sstream << column_pair.first << " ";
     }
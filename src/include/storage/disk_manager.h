@@ -1,16 +1,20 @@
 #ifndef DISK_MGR_H
 #define DISK_MGR_H
 
+#include <sys/types.h>
+
 #include <atomic>
-#include <fstream>
+#include <functional>
 #include <iostream>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "common/config.h"
 #include "common/macros.h"
 #include "page/bitmap_page.h"
 #include "page/disk_file_meta_page.h"
+#include "storage/page_io_ring.h"
 
 /**
  * DiskManager takes care of the allocation and de allocation of pages within a database. It performs the reading and
@@ -19,10 +23,24 @@
  * Disk page storage format: (Free Page BitMap Size = PAGE_SIZE * 8, we note it as N)
  * | Meta Page | Free Page BitMap 1 | Page 1 | Page 2 | ....
  *      | Page N | Free Page BitMap 2 | Page N+1 | ... | Page 2N | ... |
+ *
+ * Pages are read and written with pread/pwrite on a raw file descriptor, so page I/O needs no latch and concurrent
+ * reads do not serialize. db_io_latch_ only protects the meta page and the bitmap pages during (de)allocation.
+ *
+ * Like the meta page, the bitmap pages are cached in memory once read and written back lazily on Close(), so
+ * allocating or freeing a page does no disk I/O. The first extent that may have a free page is remembered, so
+ * allocation does not scan the extents from the start of the file.
+ *
+ * Batches of pages can be read or written asynchronously with a single system call through io_uring. Without
+ * io_uring, the batch APIs fall back to one pread/pwrite per page on the calling thread.
  */
 class DiskManager {
  public:
-  explicit DiskManager(const std::string &db_file);
+  /**
+   * @param direct_io open the file with O_DIRECT, falls back to buffered I/O if the file system does not support it
+   * @param read_only open the file read-only, writes are refused
+   */
+  explicit DiskManager(const std::string &db_file, bool direct_io = ENABLE_DIRECT_IO, bool read_only = false);
 
   ~DiskManager() {
     if (!closed) {
@@ -39,8 +57,50 @@ class DiskManager {
   /**
    * Write data to specific page
    * Note: page_id = 0 is reserved for free page bit map
+   * @return false on an I/O error
+   */
+  bool WritePage(page_id_t logical_page_id, const char *page_data);
+
+  /** A page of a batched read or write. */
+  struct PageIO {
+    page_id_t page_id_;
+    char *data_;  // PAGE_SIZE bytes, must stay valid until the callback of the page has run
+  };
+
+  /** Called once for every page of a batch, from the I/O completion thread. Must not submit new I/O. */
+  using PageIOCallback = std::function<void(page_id_t page_id, bool success)>;
+
+  /**
+   * Read a batch of pages without waiting for the reads to complete.
    */
-  void WritePage(page_id_t logical_page_id, const char *page_data);
+  void ReadPagesAsync(const std::vector<PageIO> &pages, const PageIOCallback &callback);
+
+  /**
+   * Write a batch of pages without waiting for the writes to complete.
+   */
+  void WritePagesAsync(const std::vector<PageIO> &pages, const PageIOCallback &callback);
+
+  /**
+   * Read a batch of pages and wait until all of them are read.
+   */
+  void ReadPages(const std::vector<PageIO> &pages);
+
+  /**
+   * Write a batch of pages and wait until all of them are written.
+   * @return the ids of the pages that could not be written
+   */
+  std::vector<page_id_t> WritePages(const std::vector<PageIO> &pages);
+
+  /**
+   * Map a page of the file copy-on-write at address, which must be page aligned. Changes are never written back.
+   * @return false if the page is past the end of the file or the mapping failed
+   */
+  bool MapPage(page_id_t logical_page_id, char *address);
+
+  /**
+   * @return number of physical pages in the file, an upper bound of the logical page ids in use
+   */
+  size_t GetPhysicalPageCount() const { return file_size_.load() / PAGE_SIZE; }
 
   /**
    * Get next free page from disk
@@ -74,8 +134,14 @@ class DiskManager {
  private:
   /**
    * Helper function to get disk file size
+   * @return -1 if the file does not exist
    */
-  int GetFileSize(const std::string &file_name);
+  off_t GetFileSize(const std::string &file_name);
+
+  /**
+   * Helper function to grow the cached file size after a write ending at end_offset
+   */
+  void ExtendFileSize(size_t end_offset);
 
   /**
    * Read physical page from disk
@@ -84,19 +150,56 @@ class DiskManager {
 
   /**
    * Write data to physical page in disk
+   * @return false on an I/O error
+   */
+  bool WritePhysicalPage(page_id_t physical_page_id, const char *page_data);
+
+  /**
+   * Submit a batch of reads or writes to the io_uring
    */
-  void WritePhysicalPage(page_id_t physical_page_id, const char *page_data);
+  void SubmitPages(const std::vector<PageIO> &pages, bool write, const PageIOCallback &callback);
+
+  /**
+   * Submit a batch of reads or writes and wait for all of them
+   * @return the ids of the pages whose transfer failed
+   */
+  std::vector<page_id_t> SubmitPagesAndWait(const std::vector<PageIO> &pages, bool write);
 
   /**
    * Map logical page id to physical page id
    */
   page_id_t MapPageId(page_id_t logical_page_id);
 
+  /**
+   * Get the cached bitmap page of an extent, reading it from disk on first use
+   * @param new_extent the extent has just been created and has no bitmap page on disk yet
+   */
+  BitmapPage<PAGE_SIZE> *GetBitmap(uint32_t extent_id, bool new_extent = false);
+
+  /**
+   * Write all modified bitmap pages back to disk
+   */
+  void FlushBitmaps();
+
  private:
-  // stream to write db file
-  std::fstream db_io_;
+  // file descriptor of the db file
+  int db_fd_{-1};
   std::string file_name_;
-  // with multiple buffer pool instances, need to protect file access
+  // true if db_fd_ was opened with O_DIRECT, page buffers then have to be aligned
+  bool direct_io_{false};
+  // true if db_fd_ was opened read-only
+  bool read_only_{false};
+  // size of the db file, kept in memory to avoid a stat() on every read
+  std::atomic<size_t> file_size_{0};
+  // io_uring used by the batch APIs
+  PageIORing *io_ring_{nullptr};
+  // cached bitmap pages indexed by extent id, nullptr if not read yet
+  std::vector<BitmapPage<PAGE_SIZE> *> bitmaps_;
+  // true if the cached bitmap page of an extent differs from the one on disk
+  std::vector<bool> bitmap_dirty_;
+  // no extent before this one has a free page
+  uint32_t free_extent_hint_{0};
+  // protects the meta page, the bitmap pages and the free extent hint
   std::recursive_mutex db_io_latch_;
   bool closed{false};
   char meta_data_[PAGE_SIZE];
@@ -0,0 +1,89 @@
+#ifndef MINISQL_PAGE_IO_RING_H
+#define MINISQL_PAGE_IO_RING_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+/**
+ * PageIORing submits batches of page sized reads and writes to the kernel through io_uring, so that a whole batch
+ * costs a single system call. It talks to the kernel through the raw io_uring syscalls and does not need liburing.
+ *
+ * Completions are reaped by a background thread, which runs the callback of every operation. A callback must not
+ * submit new operations, since the reaper cannot free ring slots while it runs.
+ *
+ * If io_uring is not available (old kernel, seccomp, non Linux system), IsAvailable() returns false and the caller
+ * has to fall back to synchronous I/O.
+ */
+class PageIORing {
+ public:
+  /** A single page read or write at a physical file offset. */
+  struct Operation {
+    int fd_;
+    bool write_;
+    char *data_;                        // PAGE_SIZE bytes, must stay valid until done_ has run
+    size_t offset_;
+    std::function<void(long)> done_;  // called with the number of bytes transferred, or -errno on failure
+  };
+
+  explicit PageIORing(unsigned entries = IO_RING_ENTRIES);
+
+  ~PageIORing();
+
+  DISALLOW_COPY(PageIORing)
+
+  /** @return true if the kernel supports io_uring */
+  inline bool IsAvailable() const { return ring_fd_ >= 0; }
+
+  /**
+   * Queue all operations and submit them to the kernel. Blocks only if more than the ring size are in flight.
+   */
+  void Submit(std::vector<Operation> &operations);
+
+ private:
+  /** Body of the completion thread. */
+  void ReapCompletions();
+
+  /** Put one operation into the submission queue, the caller holds submit_latch_. */
+  void PushSubmission(uint8_t opcode, Operation *operation);
+
+  /** Hand all queued submissions to the kernel, the caller holds submit_latch_. */
+  void Enter();
+
+  /** Drop the queued submissions from the submission queue and run their callbacks with -error. */
+  void FailPending(int error);
+
+  int ring_fd_{-1};
+  unsigned sq_entries_{0};
+  unsigned cq_entries_{0};
+  // submission queue, shared with the kernel
+  unsigned *sq_head_{nullptr};
+  unsigned *sq_tail_{nullptr};
+  unsigned *sq_mask_{nullptr};
+  unsigned *sq_array_{nullptr};
+  void *sqes_{nullptr};
+  // completion queue, shared with the kernel
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned *cq_mask_{nullptr};
+  void *cqes_{nullptr};
+  // mappings of the rings
+  void *sq_ring_{nullptr};
+  void *cq_ring_{nullptr};
+  size_t sq_ring_size_{0};
+  size_t cq_ring_size_{0};
+  size_t sqes_size_{0};
+
+  unsigned pending_{0};             // queued but not yet submitted
+  unsigned in_flight_{0};           // submitted but not yet reaped, bounded by cq_entries_
+  std::mutex submit_latch_;         // protects the submission queue and in_flight_
+  std::condition_variable slot_cv_;  // signaled when in_flight_ drops
+  std::thread reaper_;
+};
+
+#endif  // MINISQL_PAGE_IO_RING_H
@@ -1,6 +1,8 @@
 #ifndef MINISQL_TABLE_HEAP_H
 #define MINISQL_TABLE_HEAP_H
 
+#include <atomic>
+
 #include "buffer/buffer_pool_manager.h"
 #include "concurrency/lock_manager.h"
 #include "page/header_page.h"
@@ -26,11 +28,14 @@ class TableHeap {
 
   /**
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
+   * The search for free space starts at the last page an insert went to instead of the first page of the heap, so a
+   * bulk load does not walk the whole chain on every row. Space freed in earlier pages is not reused by inserts.
    * @param[in/out] row Tuple Row to insert, the rid of the inserted tuple is wrapped in object row
    * @param[in] txn The recovery performing the insert
+   * @param[in] strategy Access strategy of a bulk load, nullptr for a single insert
    * @return true iff the insert is successful
    */
-  bool InsertTuple(Row &row, Txn *txn);
+  bool InsertTuple(Row &row, Txn *txn, BufferAccessStrategy *strategy = nullptr);
 
   /**
    * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
@@ -89,9 +94,10 @@ class TableHeap {
   void DeleteTable(page_id_t page_id = INVALID_PAGE_ID);
 
   /**
+   * @param strategy access strategy used by the iterator for a large scan, nullptr for a regular scan
    * @return the begin iterator of this table
    */
-  TableIterator Begin(Txn *txn);
+  TableIterator Begin(Txn *txn, BufferAccessStrategy *strategy = nullptr);
 
   /**
    * @return the end iterator of this table
@@ -116,6 +122,7 @@ class TableHeap {
     buffer_pool_manager_->NewPage(first_page_id_);
     auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
     page->Init(first_page_id_, INVALID_PAGE_ID, log_manager_, txn);
+    last_page_id_ = first_page_id_;
   };
 
   explicit TableHeap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
@@ -129,6 +136,7 @@ class TableHeap {
  private:
   BufferPoolManager *buffer_pool_manager_;
   page_id_t first_page_id_;
+  atomic<page_id_t> last_page_id_{INVALID_PAGE_ID};  // page the last insert went to, INVALID_PAGE_ID until the first
   Schema *schema_;
   [[maybe_unused]] LogManager *log_manager_;
   [[maybe_unused]] LockManager *lock_manager_;
@@ -1,17 +1,19 @@
 #ifndef MINISQL_TABLE_ITERATOR_H
 #define MINISQL_TABLE_ITERATOR_H
 
+#include "buffer/buffer_access_strategy.h"
 #include "common/rowid.h"
 #include "concurrency/txn.h"
 #include "record/row.h"
 
 class TableHeap;
+class TablePage;
 
 class TableIterator {
 public:
  // you may define your own constructor based on your member variables
  explicit TableIterator(TableHeap *table_heap, RowId rid, Txn *txn, bool is_begin = false,
-                        bool is_end = false);
+                        bool is_end = false, BufferAccessStrategy *strategy = nullptr);
 
   // copy constructor
   // you may define your own copy constructor based on your member variables
@@ -39,12 +41,29 @@ public:
 
   TableIterator operator++(int);
 
+  /**
+   * Read the rows from the current one to the end of its page into rows[begin], rows[begin + 1] ..., as many as fit,
+   * and move past them. The page is fetched once for all of them, where operator* and operator++ fetch it per row.
+   * @return The number of rows read, 0 at the end of the heap
+   */
+  size_t ReadRows(std::vector<Row> &rows, size_t begin);
+
 private:
+  /** Issue read-ahead along the heap chain when the scan moves onto a new page. */
+  void ReadAhead(TablePage *page);
+
+  /** Read the row the iterator points to into row_. */
+  void LoadRow();
+
   TableHeap *table_heap_;
   RowId rid_;
   Txn *txn_;
   bool is_end_{false};  // true if this iterator is end iterator
   bool is_begin_{false};  // true if this iterator is begin iterator
+  BufferAccessStrategy *strategy_{nullptr};  // access strategy of a large scan, nullptr for a regular scan
+  Row *row_{nullptr};  // the row returned by operator* and operator->, owned by the iterator
+  size_t read_ahead_window_{0};  // number of pages requested by the last read-ahead
+  size_t pages_until_read_ahead_{0};  // pages to scan before the next read-ahead is issued
 };
 
 #endif  // MINISQL_TABLE_ITERATOR_H
@@ -1,5 +1,6 @@
 #include "index/b_plus_tree.h"
 
+#include <algorithm>
 #include <string>
 
 #include "glog/logging.h"
@@ -17,39 +18,61 @@ BPlusTree::BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_manager
       processor_(KM),
       leaf_max_size_(leaf_max_size),
       internal_max_size_(internal_max_size) {
-  if (leaf_max_size_ == UNDEFINED_SIZE) {
-    leaf_max_size_ = (PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (processor_.GetKeySize() + sizeof(RowId));
-  }
+  // a leaf splits once it is full, an internal page once it holds one more child than max size. The max size of a
+  // leaf depends on the prefix of its keys, leaf_max_size_ only limits it if given. Internal pages keep the zero
+  // padding of their keys only if a fixed width comparator reads it
+  internal_key_length_ = processor_.GetFixedKeySize() == 0 ? processor_.GetEncodedKeySize() : processor_.GetKeySize();
   if (internal_max_size_ == UNDEFINED_SIZE) {
-    internal_max_size_ = (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / (processor_.GetKeySize() + sizeof(page_id_t));
+    internal_max_size_ = (PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (internal_key_length_ + sizeof(page_id_t)) - 1;
   }
-  IndexRootsPage *index_root_page = reinterpret_cast<IndexRootsPage*>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+  Page *page = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
+  page->RLatch();
+  auto *index_root_page = reinterpret_cast<IndexRootsPage *>(page->GetData());
   if (!index_root_page->GetRootId(index_id_, &root_page_id_)) {
     root_page_id_ = INVALID_PAGE_ID;
   }
+  page->RUnlatch();
   buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, false);
 }
 
 void BPlusTree::Destroy(page_id_t current_page_id) {
+  if (current_page_id == INVALID_PAGE_ID) {
+    root_latch_.WLock();
+    if (root_page_id_ != INVALID_PAGE_ID) {
+      Destroy(root_page_id_);
+      root_page_id_ = INVALID_PAGE_ID;
+      Page *page = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
+      page->WLatch();
+      reinterpret_cast<IndexRootsPage *>(page->GetData())->Delete(index_id_);
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
+    }
+    root_latch_.WUnlock();
+    return;
+  }
+  Page *page = buffer_pool_manager_->FetchPage(current_page_id);
+  if (page == nullptr) {
+    return;
+  }
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  if (!node->IsLeafPage()) {
+    auto *internal_page = reinterpret_cast<InternalPage *>(node);
+    for (int i = 0; i < internal_page->GetSize(); i++) {
+      Destroy(internal_page->ValueAt(i));
+    }
+  }
+  buffer_pool_manager_->UnpinPage(current_page_id, false);
+  buffer_pool_manager_->DeletePage(current_page_id);
 }
 
 /*
  * Helper function to decide whether current b+tree is empty
  */
 bool BPlusTree::IsEmpty() const {
-  if(root_page_id_==INVALID_PAGE_ID) {
-    return true;
-  }
-  BPlusTreePage *root_page = reinterpret_cast<BPlusTreePage*>(buffer_pool_manager_->FetchPage(root_page_id_));
-  if (root_page == nullptr) {
-    return true;
-  }
-  if (root_page->GetSize() == 0) {
-    buffer_pool_manager_->UnpinPage(root_page_id_, false);
-    return true;
-  }
-  buffer_pool_manager_->UnpinPage(root_page_id_, false);
-  return false;
+  root_latch_.RLock();
+  bool empty = root_page_id_ == INVALID_PAGE_ID;
+  root_latch_.RUnlock();
+  return empty;
 }
 
 /*****************************************************************************
@@ -60,32 +83,20 @@ bool BPlusTree::IsEmpty() const {
  * This method is used for point query
  * @return : true means key exists
  */
-bool BPlusTree::GetValue(const GenericKey *key, std::vector<RowId> &result, Txn *transaction) { 
-  if(root_page_id_==INVALID_PAGE_ID) return false;
-  BPlusTreePage *root_page = reinterpret_cast<BPlusTreePage*>(buffer_pool_manager_->FetchPage(root_page_id_));
-  BPlusTreeLeafPage *leaf_page = reinterpret_cast<BPlusTreeLeafPage*>(FindLeafPage(key, root_page_id_));
-  if (leaf_page == nullptr) {
-    LOG(ERROR) << "Leaf page not found for key: " << key;
-    buffer_pool_manager_->UnpinPage(root_page_id_, false);
+bool BPlusTree::GetValue(const GenericKey *key, std::vector<RowId> &result, Txn *transaction) {
+  Page *page = FindLeafPage(key);
+  if (page == nullptr) {
     return false;
   }
+  auto *leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
   RowId value;
-  if (!leaf_page->Lookup(key, value, processor_)) {
-    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
-    buffer_pool_manager_->UnpinPage(root_page_id_, false);
-    return false;
-  }
-  else{
-    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
-    buffer_pool_manager_->UnpinPage(root_page_id_, false);
+  bool found = leaf_page->Lookup(key, value, processor_);
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  if (found) {
     result.push_back(value);
-    return true;
   }
-  // RowId value = leaf_page->ValueAt(leaf_page->KeyIndex(key, processor_));
-  // buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
-  // buffer_pool_manager_->UnpinPage(root_page_id_, false);
-  // result.push_back(value);
-  // return true;
+  return found;
 }
 
 /*****************************************************************************
@@ -95,68 +106,65 @@ bool BPlusTree::GetValue(const GenericKey *key, std::vector<RowId> &result, Txn
  * Insert constant key & value pair into b+ tree
  * if current tree is empty, start new tree, update root page id and insert
  * entry, otherwise insert into leaf page.
- * @return: since we only support unique key, if user try to insert duplicate
- * keys return false, otherwise return true.
+ * @return: false if the key is already in the tree, otherwise true. Keys of a
+ * non-unique index carry the RowId of their row as a suffix, so only a unique
+ * index rejects rows with equal key columns.
  */
-bool BPlusTree::Insert(GenericKey *key, const RowId &value, Txn *transaction) { 
-  if (IsEmpty()) {
+bool BPlusTree::Insert(GenericKey *key, const RowId &value, Txn *transaction) {
+  Page *page = FindLeafPageOptimistic(key, Operation::kInsert);
+  if (page != nullptr) {
+    auto *leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+    int old_size = leaf_page->GetSize();
+    bool inserted = leaf_page->Insert(key, value, processor_) > old_size;
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), inserted);
+    return inserted;
+  }
+  // the leaf may split, start over holding the whole path
+  LatchContext context;
+  root_latch_.WLock();
+  context.latched_pages_.push_back(nullptr);
+  context.siblings_.push_back(nullptr);
+  if (root_page_id_ == INVALID_PAGE_ID) {
     StartNewTree(key, value);
+    ReleaseLatches(context);
     return true;
   }
-  BPlusTreeLeafPage *leaf_page = reinterpret_cast<BPlusTreeLeafPage*>(FindLeafPage(key, root_page_id_,false));
-  //LOG(INFO) << "pin count after fetch leaf page: " << buffer_pool_manager_->pages_[2].GetPinCount();
-  if (leaf_page->Insert(key, value, processor_) == -1) {
-    //LOG(ERROR) << "Insert failed";
-    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
-    return false;
-  }
-  //LOG(INFO) << "pin count 1 " << buffer_pool_manager_->pages_[2].GetPinCount();
-  if (leaf_page->GetSize() == leaf_page->GetMaxSize()) {
-    LeafPage *new_leaf_page = Split(leaf_page, transaction);
-    InsertIntoParent(leaf_page, new_leaf_page->KeyAt(0), new_leaf_page, transaction);
-  }
-  buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), true);
-  return true;
+  page = FindLeafPagePessimistic(key, Operation::kInsert, context);
+  auto *leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+  int old_size = leaf_page->GetSize();
+  bool inserted = leaf_page->Insert(key, value, processor_) > old_size;
+  if (inserted && leaf_page->GetSize() >= leaf_page->GetMaxSize()) {
+    LeafPage *new_leaf_page = Split(leaf_page);
+    GenericKey *separator = processor_.InitKey();
+    new_leaf_page->GetLowKey(separator);
+    InsertIntoParent(leaf_page, separator, new_leaf_page, context);
+    free(separator);
+    buffer_pool_manager_->UnpinPage(new_leaf_page->GetPageId(), true);
+  }
+  ReleaseLatches(context);
+  return inserted;
 }
 /*
  * Insert constant key & value pair into an empty tree
  * User needs to first ask for new page from buffer pool manager(NOTICE: throw
  * an "out of memory" exception if returned value is nullptr), then update b+
  * tree's root page id and insert entry directly into leaf page.
+ * The caller holds root_latch_ for writing.
  */
 void BPlusTree::StartNewTree(GenericKey *key, const RowId &value) {
   page_id_t new_page_id;
-  LeafPage *new_leaf_page = reinterpret_cast<LeafPage*>(buffer_pool_manager_->NewPage(new_page_id));
-  if (new_leaf_page == nullptr) {
+  Page *page = buffer_pool_manager_->NewPage(new_page_id);
+  if (page == nullptr) {
     throw std::runtime_error("Out of memory");
   }
-  new_leaf_page->Init(new_page_id, INVALID_PAGE_ID, processor_.GetKeySize(), leaf_max_size_);
+  auto *new_leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+  new_leaf_page->Init(new_page_id, INVALID_PAGE_ID, processor_.GetKeySize(), leaf_max_size_,
+                      processor_.GetEncodedKeySize());
   new_leaf_page->Insert(key, value, processor_);
   root_page_id_ = new_page_id;
   buffer_pool_manager_->UnpinPage(new_page_id, true);
-  IndexRootsPage *index_root_page = reinterpret_cast<IndexRootsPage*>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
-  index_root_page->Insert(index_id_, root_page_id_);
-  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
-}
-
-/*
- * Insert constant key & value pair into leaf page
- * User needs to first find the right leaf page as insertion target, then look
- * through leaf page to see whether insert key exist or not. If exist, return
- * immediately, otherwise insert entry. Remember to deal with split if necessary.
- * @return: since we only support unique key, if user try to insert duplicate
- * keys return false, otherwise return true.
- */
-bool BPlusTree::InsertIntoLeaf(GenericKey *key, const RowId &value, Txn *transaction) { 
-  BPlusTreeLeafPage *leaf_page = reinterpret_cast<BPlusTreeLeafPage*>(FindLeafPage(key, root_page_id_));
-  if (leaf_page->Insert(key, value, processor_) == -1) {
-    return false;
-  }
-  if (leaf_page->GetSize() == leaf_page->GetMaxSize()) {
-    LeafPage *new_leaf_page = Split(leaf_page, transaction);
-    InsertIntoParent(leaf_page, new_leaf_page->KeyAt(0), new_leaf_page, transaction);
-  }
-  return true;
+  UpdateRootPageId(1);
 }
 
 /*
@@ -165,32 +173,35 @@ bool BPlusTree::InsertIntoLeaf(GenericKey *key, const RowId &value, Txn *transac
  * User needs to first ask for new page from buffer pool manager(NOTICE: throw
  * an "out of memory" exception if returned value is nullptr), then move half
  * of key & value pairs from input page to newly created page
+ * The new page is not latched, nobody can reach it before its parent is updated.
  */
-BPlusTreeInternalPage *BPlusTree::Split(InternalPage *node, Txn *transaction) { 
+BPlusTreeInternalPage *BPlusTree::Split(InternalPage *node) {
   page_id_t new_page_id;
-  InternalPage *new_internal_page = reinterpret_cast<InternalPage*>(buffer_pool_manager_->NewPage(new_page_id));
-  if (new_internal_page == nullptr) {
+  Page *page = buffer_pool_manager_->NewPage(new_page_id);
+  if (page == nullptr) {
     throw std::runtime_error("Out of memory");
   }
-  new_internal_page->Init(new_page_id, node->GetParentPageId(), processor_.GetKeySize(), internal_max_size_);
+  auto *new_internal_page = reinterpret_cast<InternalPage *>(page->GetData());
+  new_internal_page->Init(new_page_id, node->GetParentPageId(), processor_.GetKeySize(), internal_max_size_,
+                          internal_key_length_);
   node->MoveHalfTo(new_internal_page, buffer_pool_manager_);
-  buffer_pool_manager_->UnpinPage(new_page_id, true);
   return new_internal_page;
- }
+}
 
-BPlusTreeLeafPage *BPlusTree::Split(LeafPage *node, Txn *transaction) { 
+BPlusTreeLeafPage *BPlusTree::Split(LeafPage *node) {
   page_id_t new_page_id;
-  LeafPage *new_leaf_page = reinterpret_cast<LeafPage*>(buffer_pool_manager_->NewPage(new_page_id));
-  if (new_leaf_page == nullptr) {
+  Page *page = buffer_pool_manager_->NewPage(new_page_id);
+  if (page == nullptr) {
     throw std::runtime_error("Out of memory");
   }
-  new_leaf_page->Init(new_page_id, node->GetParentPageId(), processor_.GetKeySize(), leaf_max_size_);
+  auto *new_leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+  new_leaf_page->Init(new_page_id, node->GetParentPageId(), processor_.GetKeySize(), leaf_max_size_,
+                      processor_.GetEncodedKeySize());
   node->MoveHalfTo(new_leaf_page);
   new_leaf_page->SetNextPageId(node->GetNextPageId());
   node->SetNextPageId(new_page_id);
-  buffer_pool_manager_->UnpinPage(new_page_id, true);
   return new_leaf_page;
- }
+}
 
 /*
  * Insert key & value pair into internal page after split
@@ -200,35 +211,180 @@ BPlusTreeLeafPage *BPlusTree::Split(LeafPage *node, Txn *transaction) {
  * User needs to first find the parent page of old_node, parent node must be
  * adjusted to take info of new_node into account. Remember to deal with split
  * recursively if necessary.
+ * old_node was not safe, so its parent (or root_latch_) is still write latched in the context.
  */
-void BPlusTree::InsertIntoParent(BPlusTreePage *old_node, GenericKey *key, BPlusTreePage *new_node, Txn *transaction) {
-  if(old_node->IsRootPage()){
+void BPlusTree::InsertIntoParent(BPlusTreePage *old_node, GenericKey *key, BPlusTreePage *new_node,
+                                 LatchContext &context) {
+  if (old_node->IsRootPage()) {
     page_id_t new_root_page_id;
-    InternalPage *new_root_page = reinterpret_cast<InternalPage*>(buffer_pool_manager_->NewPage(new_root_page_id));
-    if (new_root_page == nullptr) {
+    Page *page = buffer_pool_manager_->NewPage(new_root_page_id);
+    if (page == nullptr) {
       throw std::runtime_error("Out of memory");
     }
-    new_root_page->Init(new_root_page_id, INVALID_PAGE_ID, processor_.GetKeySize(), internal_max_size_);
-    root_page_id_ = new_root_page_id;
-    new_root_page->SetPageType(IndexPageType::INTERNAL_PAGE);
-    new_root_page->SetValueAt(0,old_node->GetPageId());
-    new_root_page->SetSize(1);
+    auto *new_root_page = reinterpret_cast<InternalPage *>(page->GetData());
+    new_root_page->Init(new_root_page_id, INVALID_PAGE_ID, processor_.GetKeySize(), internal_max_size_,
+                        internal_key_length_);
     new_root_page->PopulateNewRoot(old_node->GetPageId(), key, new_node->GetPageId());
     old_node->SetParentPageId(new_root_page_id);
     new_node->SetParentPageId(new_root_page_id);
+    root_page_id_ = new_root_page_id;
+    UpdateRootPageId(0);
     buffer_pool_manager_->UnpinPage(new_root_page_id, true);
     return;
   }
-  BPlusTreeInternalPage* parent_page = reinterpret_cast<BPlusTreeInternalPage*>(buffer_pool_manager_->FetchPage(old_node->GetParentPageId()));
-  if (parent_page->GetSize() == parent_page->GetMaxSize()) {
-    InternalPage *new_internal_page = Split(parent_page, transaction);
-    InsertIntoParent(parent_page, new_internal_page->KeyAt(0), new_internal_page, transaction);
+  Page *page = context.latched_pages_[FindLatched(old_node, context) - 1];
+  auto *parent_page = reinterpret_cast<InternalPage *>(page->GetData());
+  parent_page->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
+  new_node->SetParentPageId(parent_page->GetPageId());
+  if (parent_page->GetSize() > parent_page->GetMaxSize()) {
+    InternalPage *new_internal_page = Split(parent_page);
+    InsertIntoParent(parent_page, new_internal_page->KeyAt(0), new_internal_page, context);
+    buffer_pool_manager_->UnpinPage(new_internal_page->GetPageId(), true);
   }
-  else {
-    parent_page->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
-    new_node->SetParentPageId(parent_page->GetPageId());
+}
+
+/*****************************************************************************
+ * BULK LOAD
+ *****************************************************************************/
+/*
+ * Leaves are filled left to right straight from the sorted entries, then every internal level is built over the
+ * level below until a single root is left. Nobody can reach the new pages before the root is set, so they are not
+ * latched, root_latch_ is held for the whole build.
+ */
+dberr_t BPlusTree::BulkLoad(IndexKeySorter &sorter, int fill_factor) {
+  root_latch_.WLock();
+  if (root_page_id_ != INVALID_PAGE_ID) {
+    root_latch_.WUnlock();
+    return DB_FAILED;
+  }
+  fill_factor = std::min(std::max(fill_factor, 50), 100);
+  // a leaf splits once it is full
+  auto leaf_fill = [fill_factor](int max_size) {
+    return std::max(1, std::min(max_size * fill_factor / 100, max_size - 1));
+  };
+  int key_size = processor_.GetKeySize();
+  std::vector<char> keys;
+  std::vector<page_id_t> pages;
+  LeafPage *prev_leaf_page = nullptr;
+  LeafPage *leaf_page = nullptr;
+  // append a leaf to the chain, its low key goes into keys once its key range is set
+  auto append_leaf = [&]() {
+    page_id_t new_page_id;
+    Page *page = buffer_pool_manager_->NewPage(new_page_id);
+    if (page == nullptr) {
+      throw std::runtime_error("Out of memory");
+    }
+    auto *new_leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+    new_leaf_page->Init(new_page_id, INVALID_PAGE_ID, key_size, leaf_max_size_, processor_.GetEncodedKeySize());
+    if (leaf_page != nullptr) {
+      leaf_page->SetNextPageId(new_page_id);
+    }
+    if (prev_leaf_page != nullptr) {
+      buffer_pool_manager_->UnpinPage(prev_leaf_page->GetPageId(), true);
+    }
+    prev_leaf_page = leaf_page;
+    leaf_page = new_leaf_page;
+    keys.resize(keys.size() + key_size);
+    pages.push_back(new_page_id);
+  };
+  auto last_low_key = [&]() { return reinterpret_cast<GenericKey *>(keys.data() + keys.size() - key_size); };
+  // give the last leaf its high key, the shorter prefix may not hold all of its keys, so split it until they fit
+  auto close_leaf = [&](const GenericKey *high_key) {
+    while (leaf_page->GetSize() >= leaf_page->GetMaxSizeUpTo(high_key)) {
+      LeafPage *full_leaf_page = leaf_page;
+      append_leaf();
+      full_leaf_page->MoveHalfTo(leaf_page);
+      leaf_page->GetLowKey(last_low_key());
+    }
+    leaf_page->SetHighKey(high_key);
+  };
+  GenericKey *key;
+  RowId value;
+  bool duplicate = false;
+  // while a leaf is filled its high key is its last key, so its prefix is as long as its keys allow
+  while (sorter.Next(key, value)) {
+    if (leaf_page != nullptr && leaf_page->CompareKeyAt(leaf_page->GetSize() - 1, key) == 0) {
+      duplicate = true;
+      break;
+    }
+    if (leaf_page == nullptr) {
+      append_leaf();
+      leaf_page->GetLowKey(last_low_key());
+    } else if (leaf_page->GetSize() >= leaf_fill(leaf_page->GetMaxSizeUpTo(key))) {
+      close_leaf(key);
+      append_leaf();
+      leaf_page->SetKeyRange(key, key);
+      leaf_page->GetLowKey(last_low_key());
+    }
+    leaf_page->SetHighKey(key);
+    leaf_page->SetKeyAt(leaf_page->GetSize(), key);
+    leaf_page->SetValueAt(leaf_page->GetSize(), value);
+    leaf_page->IncreaseSize(1);
+  }
+  if (leaf_page != nullptr) {
+    GenericKey *high_key = processor_.InitKey();
+    memset(high_key, 0xff, key_size);
+    close_leaf(high_key);
+    free(high_key);
+  }
+  if (prev_leaf_page != nullptr) {
+    // even out the last two leaves rather than leaving the last one nearly empty
+    while (leaf_page->GetSize() < leaf_page->GetMinSize() && prev_leaf_page->GetSize() > leaf_page->GetSize() + 1) {
+      prev_leaf_page->MoveLastToFrontOf(leaf_page);
+    }
+    leaf_page->GetLowKey(last_low_key());
+    buffer_pool_manager_->UnpinPage(prev_leaf_page->GetPageId(), true);
   }
-  buffer_pool_manager_->UnpinPage(parent_page->GetPageId(), true);
+  if (leaf_page != nullptr) {
+    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), true);
+  }
+  while (pages.size() > 1) {
+    BulkLoadInternalLevel(keys, pages, fill_factor);
+  }
+  if (!pages.empty()) {
+    root_page_id_ = pages[0];
+    UpdateRootPageId(1);
+  }
+  root_latch_.WUnlock();
+  return duplicate ? DB_ALREADY_EXIST : DB_SUCCESS;
+}
+
+/*
+ * The number of pages of a level is known up front, so children are spread evenly over its pages.
+ */
+void BPlusTree::BulkLoadInternalLevel(std::vector<char> &keys, std::vector<page_id_t> &pages, int fill_factor) {
+  int key_size = processor_.GetKeySize();
+  // at least 3 children, so that spreading never leaves a page with a single child
+  size_t fill = std::max(3, std::min(internal_max_size_ * fill_factor / 100, internal_max_size_));
+  size_t page_count = (pages.size() + fill - 1) / fill;
+  std::vector<char> level_keys;
+  std::vector<page_id_t> level_pages;
+  size_t child = 0;
+  for (size_t i = 0; i < page_count; i++) {
+    int size = static_cast<int>(pages.size() / page_count + (i < pages.size() % page_count ? 1 : 0));
+    page_id_t new_page_id;
+    Page *page = buffer_pool_manager_->NewPage(new_page_id);
+    if (page == nullptr) {
+      throw std::runtime_error("Out of memory");
+    }
+    auto *internal_page = reinterpret_cast<InternalPage *>(page->GetData());
+    internal_page->Init(new_page_id, INVALID_PAGE_ID, key_size, internal_max_size_, internal_key_length_);
+    // the first key is never searched, it is the first key of the new page on the next level
+    for (int j = 0; j < size; j++, child++) {
+      internal_page->SetKeyAt(j, reinterpret_cast<GenericKey *>(keys.data() + child * key_size));
+      internal_page->SetValueAt(j, pages[child]);
+      auto *child_page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(pages[child])->GetData());
+      child_page->SetParentPageId(new_page_id);
+      buffer_pool_manager_->UnpinPage(pages[child], true);
+    }
+    internal_page->SetSize(size);
+    char *first_key = keys.data() + (child - size) * key_size;
+    level_keys.insert(level_keys.end(), first_key, first_key + key_size);
+    level_pages.push_back(new_page_id);
+    buffer_pool_manager_->UnpinPage(new_page_id, true);
+  }
+  keys.swap(level_keys);
+  pages.swap(level_pages);
 }
 
 /*****************************************************************************
@@ -242,116 +398,107 @@ void BPlusTree::InsertIntoParent(BPlusTreePage *old_node, GenericKey *key, BPlus
  * necessary.
  */
 void BPlusTree::Remove(const GenericKey *key, Txn *transaction) {
-  if (IsEmpty()) {
+  Page *page = FindLeafPageOptimistic(key, Operation::kRemove);
+  if (page != nullptr) {
+    auto *leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+    bool removed = leaf_page->RemoveAndDeleteRecord(key, processor_) != -1;
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), removed);
     return;
   }
-  BPlusTreeLeafPage *leaf_page = reinterpret_cast<BPlusTreeLeafPage*>(FindLeafPage(key, root_page_id_));
-  if (leaf_page->RemoveAndDeleteRecord(key, processor_) == -1) {
-    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+  // the leaf may underflow, start over holding the whole path
+  LatchContext context;
+  root_latch_.WLock();
+  context.latched_pages_.push_back(nullptr);
+  context.siblings_.push_back(nullptr);
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    ReleaseLatches(context);
     return;
   }
-  // LOG(INFO) << "page "<<leaf_page->GetPageId()<< " page size: "<<leaf_page->GetSize();
-  if (leaf_page->GetSize() < leaf_page->GetMinSize() && leaf_page->IsRootPage() == false) {
-    // LOG(INFO)<<"CoalesceOrRedistribute(leaf_page, transaction) for page "<<leaf_page->GetPageId();
-    if(CoalesceOrRedistribute(leaf_page, transaction)){
-      buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), true);
-     }
-    // if(CoalesceOrRedistribute(leaf_page, transaction)){
-    //   buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), true);
-    //   buffer_pool_manager_->DeletePage(leaf_page->GetPageId());
-    // }
-    // else {
-    //   buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), true);
-    // }
-    
-  }
-  else {
-    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), true);
+  page = FindLeafPagePessimistic(key, Operation::kRemove, context);
+  auto *leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+  if (leaf_page->RemoveAndDeleteRecord(key, processor_) != -1) {
+    if (leaf_page->IsRootPage()) {
+      AdjustRoot(leaf_page, context);
+    } else if (leaf_page->GetSize() < leaf_page->GetMinSize()) {
+      CoalesceOrRedistribute(leaf_page, context);
+    }
   }
+  ReleaseLatches(context);
 }
 
 /* todo
  * User needs to first find the sibling of input page. If sibling's size + input
  * page's size > page's max size, then redistribute. Otherwise, merge.
  * Using template N to represent either internal page or leaf page.
- * @return: true means target leaf page should be deleted, false means no
- * deletion happens
+ * The parent and the sibling of node have been write latched by the descent.
+ * A leaf underflows below half of its uncompressed max size, which a page over both key ranges always exceeds, so a
+ * redistributed leaf never runs out of space when its prefix gets shorter.
  */
 template <typename N>
-bool BPlusTree::CoalesceOrRedistribute(N *&node, Txn *transaction) {
-  if(node->IsRootPage()) return true;
-  BPlusTreeInternalPage *parent_page = reinterpret_cast<BPlusTreeInternalPage*>(buffer_pool_manager_->FetchPage(node->GetParentPageId()));
+void BPlusTree::CoalesceOrRedistribute(N *node, LatchContext &context) {
+  size_t latched_index = FindLatched(node, context);
+  auto *parent_page = reinterpret_cast<InternalPage *>(context.latched_pages_[latched_index - 1]->GetData());
+  auto *neighbor_node = reinterpret_cast<N *>(context.siblings_[latched_index]->GetData());
   int index = parent_page->ValueIndex(node->GetPageId());
-
-  // LOG(INFO)<<"Parent page "<<parent_page->GetPageId();
-  // for(int i = 0; i < parent_page->GetSize(); i++) {
-  //   LOG(INFO)<<" index "<<i<<" value "<<parent_page->ValueAt(i);
-  // }
-
-  BPlusTreePage *neighbor_node;
-  bool coalesce_result;
-  if(index == 0) neighbor_node = reinterpret_cast<BPlusTreePage*>(buffer_pool_manager_->FetchPage(parent_page->ValueAt(1)));
-  else neighbor_node = reinterpret_cast<BPlusTreePage*>(buffer_pool_manager_->FetchPage(parent_page->ValueAt(index - 1)));
-  if (neighbor_node->GetSize() + node->GetSize() >= node->GetMaxSize()) {
-    // LOG(INFO)<<"Redistribute for page "<<node->GetPageId()<<" and its neighbor "<<neighbor_node->GetPageId();
-    if(neighbor_node->IsLeafPage()) Redistribute(reinterpret_cast<BPlusTreeLeafPage*>(neighbor_node), reinterpret_cast<BPlusTreeLeafPage*>(node), index);
-    else Redistribute(reinterpret_cast<BPlusTreeInternalPage*>(neighbor_node), reinterpret_cast<BPlusTreeInternalPage*>(node), index);
-    buffer_pool_manager_->UnpinPage(neighbor_node->GetPageId(), true);
-    buffer_pool_manager_->UnpinPage(parent_page->GetPageId(), true);
-    return false;
+  ASSERT(neighbor_node->GetPageId() == parent_page->ValueAt(index == 0 ? 1 : index - 1), "Wrong sibling latched.");
+  N *left = index == 0 ? node : neighbor_node;
+  N *right = index == 0 ? neighbor_node : node;
+  if (neighbor_node->GetSize() + node->GetSize() >= GetMergedMaxSize(left, right)) {
+    Redistribute(neighbor_node, node, parent_page, index);
   } else {
-    // LOG(INFO)<<"Coalesce for page "<<node->GetPageId()<<" and its neighbor "<<neighbor_node->GetPageId();
-    if(neighbor_node->IsLeafPage()) coalesce_result=Coalesce(reinterpret_cast<BPlusTreeLeafPage*&>(neighbor_node), reinterpret_cast<BPlusTreeLeafPage*&>(node), parent_page, index, transaction);
-    else coalesce_result=Coalesce(reinterpret_cast<BPlusTreeInternalPage*&>(neighbor_node), reinterpret_cast<BPlusTreeInternalPage*&>(node), parent_page, index, transaction);
-    //Coalesce(neighbor_node, node, parent_page, index, transaction);
-    if(parent_page->IsRootPage() && parent_page->GetSize()==0)AdjustRoot(parent_page);
-    buffer_pool_manager_->UnpinPage(neighbor_node->GetPageId(), true);
-    buffer_pool_manager_->UnpinPage(parent_page->GetPageId(), true);
-    if(coalesce_result) {
-      buffer_pool_manager_->DeletePage(parent_page->GetPageId());
-    }
-    return true;
+    Coalesce(neighbor_node, node, parent_page, index, context);
   }
 }
 
+/*
+ * The key range of a merged leaf spans both siblings, so its prefix and max size may be smaller than theirs.
+ */
+int BPlusTree::GetMergedMaxSize(LeafPage *left, LeafPage *right) const { return left->GetMergedMaxSize(right); }
+
+int BPlusTree::GetMergedMaxSize(InternalPage *left, InternalPage *right) const { return left->GetMaxSize(); }
+
 /*
  * Move all the key & value pairs from one page to its sibling page, and notify
  * buffer pool manager to delete this page. Parent page must be adjusted to
  * take info of deletion into account. Remember to deal with coalesce or
  * redistribute recursively if necessary.
  * Using template N to represent either internal page or leaf page.
+ * The right page is always merged into the left one, so only the left page of the leaf chain changes.
  * @param   neighbor_node      sibling page of input "node"
  * @param   node               input from method coalesceOrRedistribute()
  * @param   parent             parent page of input "node"
- * @return  true means parent node should be deleted, false means no deletion happened
  */
-bool BPlusTree::Coalesce(LeafPage *&neighbor_node, LeafPage *&node, InternalPage *&parent, int index,
-                         Txn *transaction) {
-  LeafPage *temp;
+void BPlusTree::Coalesce(LeafPage *neighbor_node, LeafPage *node, InternalPage *parent, int index,
+                         LatchContext &context) {
   if (index == 0) {
-    neighbor_node->MoveAllTo(node);
-    parent->Remove(1);
-    temp=neighbor_node;neighbor_node = node;node=temp;
+    std::swap(neighbor_node, node);
+    index = 1;
   }
-  else {node->MoveAllTo(neighbor_node);parent->Remove(index);}
-  buffer_pool_manager_->UnpinPage(node->GetPageId(), false);
-  buffer_pool_manager_->DeletePage(node->GetPageId());
-  if (parent->GetSize() < parent->GetMinSize() && parent->IsRootPage() == false) {
-    return CoalesceOrRedistribute(parent, transaction);
+  node->MoveAllTo(neighbor_node);
+  parent->Remove(index);
+  context.deleted_pages_.push_back(node->GetPageId());
+  if (parent->IsRootPage()) {
+    AdjustRoot(parent, context);
+  } else if (parent->GetSize() < parent->GetMinSize()) {
+    CoalesceOrRedistribute(parent, context);
   }
-  return false;
 }
 
-bool BPlusTree::Coalesce(InternalPage *&neighbor_node, InternalPage *&node, InternalPage *&parent, int index,
-                         Txn *transaction) {
-  node->MoveAllTo(neighbor_node, node->KeyAt(0), buffer_pool_manager_);
-  buffer_pool_manager_->UnpinPage(node->GetPageId(), false);
-  buffer_pool_manager_->DeletePage(node->GetPageId());
+void BPlusTree::Coalesce(InternalPage *neighbor_node, InternalPage *node, InternalPage *parent, int index,
+                         LatchContext &context) {
+  if (index == 0) {
+    std::swap(neighbor_node, node);
+    index = 1;
+  }
+  node->MoveAllTo(neighbor_node, parent->KeyAt(index), buffer_pool_manager_);
   parent->Remove(index);
-  if (parent->GetSize() < parent->GetMinSize()) {
-    return CoalesceOrRedistribute(parent, transaction);
+  context.deleted_pages_.push_back(node->GetPageId());
+  if (parent->IsRootPage()) {
+    AdjustRoot(parent, context);
+  } else if (parent->GetSize() < parent->GetMinSize()) {
+    CoalesceOrRedistribute(parent, context);
   }
-  return false;
 }
 
 /*
@@ -363,23 +510,30 @@ bool BPlusTree::Coalesce(InternalPage *&neighbor_node, InternalPage *&node, Inte
  * @param   neighbor_node      sibling page of input "node"
  * @param   node               input from method coalesceOrRedistribute()
  */
-void BPlusTree::Redistribute(LeafPage *neighbor_node, LeafPage *node, int index) {
-  if(index==0) {
+void BPlusTree::Redistribute(LeafPage *neighbor_node, LeafPage *node, InternalPage *parent, int index) {
+  // the low key of the right page is the new separator
+  GenericKey *separator = processor_.InitKey();
+  if (index == 0) {
     neighbor_node->MoveFirstToEndOf(node);
-    InternalPage *parent_page = reinterpret_cast<InternalPage*>(buffer_pool_manager_->FetchPage(node->GetParentPageId()));
-    parent_page->SetKeyAt(0, neighbor_node->KeyAt(0));
-    buffer_pool_manager_->UnpinPage(parent_page->GetPageId(), true);
-  }
-  else {
+    neighbor_node->GetLowKey(separator);
+    parent->SetKeyAt(1, separator);
+  } else {
     neighbor_node->MoveLastToFrontOf(node);
-    InternalPage *parent_page = reinterpret_cast<InternalPage*>(buffer_pool_manager_->FetchPage(node->GetParentPageId()));
-    parent_page->SetKeyAt(index, node->KeyAt(0));
-    buffer_pool_manager_->UnpinPage(parent_page->GetPageId(), true);
+    node->GetLowKey(separator);
+    parent->SetKeyAt(index, separator);
   }
+  free(separator);
 }
-void BPlusTree::Redistribute(InternalPage *neighbor_node, InternalPage *node, int index) {
-  if(index==0) neighbor_node->MoveFirstToEndOf(node, neighbor_node->KeyAt(0), buffer_pool_manager_);
-  else neighbor_node->MoveLastToFrontOf(node, neighbor_node->KeyAt(neighbor_node->GetSize() - 1), buffer_pool_manager_);
+
+void BPlusTree::Redistribute(InternalPage *neighbor_node, InternalPage *node, InternalPage *parent, int index) {
+  // the separator moves down into the receiving page, the unused first key of the right page moves up
+  if (index == 0) {
+    neighbor_node->MoveFirstToEndOf(node, parent->KeyAt(1), buffer_pool_manager_);
+    parent->SetKeyAt(1, neighbor_node->KeyAt(0));
+  } else {
+    neighbor_node->MoveLastToFrontOf(node, parent->KeyAt(index), buffer_pool_manager_);
+    parent->SetKeyAt(index, node->KeyAt(0));
+  }
 }
 /*
  * Update root page if necessary
@@ -390,23 +544,24 @@ void BPlusTree::Redistribute(InternalPage *neighbor_node, InternalPage *node, in
  * case 2: when you delete the last element in whole b+ tree
  * @return : true means root page should be deleted, false means no deletion
  * happened
+ * The old root is deleted once the operation releases its latches.
  */
-bool BPlusTree::AdjustRoot(BPlusTreePage *old_root_node) {
-  if (old_root_node->GetSize() == 0) {
-    BPlusTreeInternalPage *internal_page = reinterpret_cast<BPlusTreeInternalPage *>(old_root_node);
+bool BPlusTree::AdjustRoot(BPlusTreePage *old_root_node, LatchContext &context) {
+  if (!old_root_node->IsLeafPage() && old_root_node->GetSize() == 1) {
+    auto *internal_page = reinterpret_cast<InternalPage *>(old_root_node);
     page_id_t child_page_id = internal_page->RemoveAndReturnOnlyChild();
-    buffer_pool_manager_->UnpinPage(old_root_node->GetPageId(), false);
-    buffer_pool_manager_->DeletePage(old_root_node->GetPageId());
-    root_page_id_ = child_page_id;
-    BPlusTreePage *child_page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(child_page_id));
+    auto *child_page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(child_page_id)->GetData());
     child_page->SetParentPageId(INVALID_PAGE_ID);
     buffer_pool_manager_->UnpinPage(child_page_id, true);
-    IndexRootsPage *index_root_page = reinterpret_cast<IndexRootsPage*>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
-    index_root_page->Update(index_id_, root_page_id_);
-    buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
-    return true;
+    root_page_id_ = child_page_id;
+  } else if (old_root_node->IsLeafPage() && old_root_node->GetSize() == 0) {
+    root_page_id_ = INVALID_PAGE_ID;
+  } else {
+    return false;
   }
-  return false;
+  UpdateRootPageId(0);
+  context.deleted_pages_.push_back(old_root_node->GetPageId());
+  return true;
 }
 
 /*****************************************************************************
@@ -418,7 +573,11 @@ bool BPlusTree::AdjustRoot(BPlusTreePage *old_root_node) {
  * @return : index iterator
  */
 IndexIterator BPlusTree::Begin() {
-  return IndexIterator(root_page_id_, buffer_pool_manager_, 0);
+  Page *page = FindLeafPage(nullptr, INVALID_PAGE_ID, true);
+  if (page == nullptr) {
+    return End();
+  }
+  return IndexIterator(page, buffer_pool_manager_, 0);
 }
 
 /*
@@ -427,8 +586,12 @@ IndexIterator BPlusTree::Begin() {
  * @return : index iterator
  */
 IndexIterator BPlusTree::Begin(const GenericKey *key) {
-  BPlusTreeLeafPage *leaf_page = reinterpret_cast<BPlusTreeLeafPage*>(FindLeafPage(key, root_page_id_));
-  return IndexIterator(leaf_page->GetPageId(), buffer_pool_manager_, leaf_page->KeyIndex(key, processor_));
+  Page *page = FindLeafPage(key);
+  if (page == nullptr) {
+    return End();
+  }
+  auto *leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+  return IndexIterator(page, buffer_pool_manager_, leaf_page->KeyIndex(key, processor_));
 }
 
 /*
@@ -437,7 +600,7 @@ IndexIterator BPlusTree::Begin(const GenericKey *key) {
  * @return : index iterator
  */
 IndexIterator BPlusTree::End() {
-  return IndexIterator(INVALID_PAGE_ID, buffer_pool_manager_, 0);
+  return IndexIterator();
 }
 
 /*****************************************************************************
@@ -446,26 +609,188 @@ IndexIterator BPlusTree::End() {
 /*
  * Find leaf page containing particular key, if leftMost flag == true, find
  * the left most leaf page
- * Note: the leaf page is pinned, you need to unpin it after use.
+ * Note: the leaf page is pinned and read latched, you need to unlatch and unpin it after use.
+ * The search starts from the root unless page_id is given.
  */
 Page *BPlusTree::FindLeafPage(const GenericKey *key, page_id_t page_id, bool leftMost) {
-  if(page_id == INVALID_PAGE_ID||page_id<=0) {
-    LOG(ERROR) << "Invalid page id "<<page_id<< " for FindLeafPage";
+  bool from_root = page_id == INVALID_PAGE_ID;
+  if (from_root) {
+    root_latch_.RLock();
+    if (root_page_id_ == INVALID_PAGE_ID) {
+      root_latch_.RUnlock();
+      return nullptr;
+    }
+    page_id = root_page_id_;
+  }
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  page->RLatch();
+  if (from_root) {
+    root_latch_.RUnlock();
+  }
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  while (!node->IsLeafPage()) {
+    auto *internal_page = reinterpret_cast<InternalPage *>(node);
+    page_id_t child_page_id = leftMost ? internal_page->ValueAt(0) : internal_page->Lookup(key, processor_);
+    Page *child = buffer_pool_manager_->FetchPage(child_page_id);
+    child->RLatch();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = child;
+    node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  }
+  return page;
+}
+
+/*
+ * The type of a page never changes while it is reachable, so it is read before latching the page.
+ */
+Page *BPlusTree::FindLeafPageOptimistic(const GenericKey *key, Operation operation) {
+  root_latch_.RLock();
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    root_latch_.RUnlock();
     return nullptr;
   }
-  BPlusTreePage *page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
-  if (page->IsLeafPage()) {
-    return reinterpret_cast<Page *>(page);
-  }
-  InternalPage *internal_page = reinterpret_cast<InternalPage *>(page);
-  page_id_t child_page_id;
-  if (leftMost) {
-    child_page_id = internal_page->ValueAt(0);
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  if (node->IsLeafPage()) {
+    page->WLatch();
   } else {
-    child_page_id = internal_page->Lookup(key, processor_);
+    page->RLatch();
+  }
+  root_latch_.RUnlock();
+  while (!node->IsLeafPage()) {
+    Page *child = buffer_pool_manager_->FetchPage(reinterpret_cast<InternalPage *>(node)->Lookup(key, processor_));
+    node = reinterpret_cast<BPlusTreePage *>(child->GetData());
+    if (node->IsLeafPage()) {
+      child->WLatch();
+    } else {
+      child->RLatch();
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = child;
   }
-  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
-  return FindLeafPage(key, child_page_id, leftMost);
+  if (!IsSafe(node, operation)) {
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    return nullptr;
+  }
+  return page;
+}
+
+/*
+ * A remove also latches the sibling of every page on the path, left before right, see the class comment.
+ */
+Page *BPlusTree::FindLeafPagePessimistic(const GenericKey *key, Operation operation, LatchContext &context) {
+  Page *page = FetchAndWLatch(root_page_id_);
+  context.latched_pages_.push_back(page);
+  context.siblings_.push_back(nullptr);
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  if (IsSafe(node, operation)) {
+    ReleaseAncestors(context);
+  }
+  while (!node->IsLeafPage()) {
+    auto *internal_page = reinterpret_cast<InternalPage *>(node);
+    page_id_t child_page_id = internal_page->Lookup(key, processor_);
+    int index = internal_page->ValueIndex(child_page_id);
+    Page *sibling = nullptr;
+    if (operation == Operation::kRemove && index > 0) {
+      sibling = FetchAndWLatch(internal_page->ValueAt(index - 1));
+    }
+    page = FetchAndWLatch(child_page_id);
+    if (operation == Operation::kRemove && index == 0) {
+      sibling = FetchAndWLatch(internal_page->ValueAt(1));
+    }
+    context.latched_pages_.push_back(page);
+    context.siblings_.push_back(sibling);
+    node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    if (IsSafe(node, operation)) {
+      ReleaseAncestors(context);
+    }
+  }
+  return page;
+}
+
+bool BPlusTree::IsSafe(BPlusTreePage *node, Operation operation) const {
+  switch (operation) {
+    case Operation::kInsert:
+      // a leaf splits once it is full, an internal page once it overflows
+      if (node->IsLeafPage()) {
+        return node->GetSize() + 1 < node->GetMaxSize();
+      }
+      return node->GetSize() < node->GetMaxSize();
+    case Operation::kRemove:
+      if (node->IsRootPage()) {
+        return node->GetSize() > (node->IsLeafPage() ? 1 : 2);
+      }
+      if (node->IsLeafPage()) {
+        return node->GetSize() > reinterpret_cast<LeafPage *>(node)->GetMinSize();
+      }
+      return node->GetSize() > node->GetMinSize();
+    default:
+      return true;
+  }
+}
+
+void BPlusTree::ReleaseAncestors(LatchContext &context) {
+  size_t last = context.latched_pages_.size() - 1;
+  for (size_t i = 0; i <= last; i++) {
+    Page *page = context.latched_pages_[i];
+    if (i < last) {
+      if (page == nullptr) {
+        root_latch_.WUnlock();
+      } else {
+        page->WUnlatch();
+        buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      }
+    }
+    Page *sibling = context.siblings_[i];
+    if (sibling != nullptr) {
+      sibling->WUnlatch();
+      buffer_pool_manager_->UnpinPage(sibling->GetPageId(), false);
+    }
+  }
+  context.latched_pages_.erase(context.latched_pages_.begin(), context.latched_pages_.begin() + last);
+  context.siblings_.assign(1, nullptr);
+}
+
+void BPlusTree::ReleaseLatches(LatchContext &context) {
+  for (size_t i = 0; i < context.latched_pages_.size(); i++) {
+    Page *page = context.latched_pages_[i];
+    if (page == nullptr) {
+      root_latch_.WUnlock();
+    } else {
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+    }
+    Page *sibling = context.siblings_[i];
+    if (sibling != nullptr) {
+      sibling->WUnlatch();
+      buffer_pool_manager_->UnpinPage(sibling->GetPageId(), true);
+    }
+  }
+  context.latched_pages_.clear();
+  context.siblings_.clear();
+  for (page_id_t page_id : context.deleted_pages_) {
+    buffer_pool_manager_->DeletePage(page_id);
+  }
+  context.deleted_pages_.clear();
+}
+
+Page *BPlusTree::FetchAndWLatch(page_id_t page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  page->WLatch();
+  return page;
+}
+
+size_t BPlusTree::FindLatched(const BPlusTreePage *node, const LatchContext &context) const {
+  for (size_t i = context.latched_pages_.size() - 1; i > 0; i--) {
+    if (context.latched_pages_[i] != nullptr && context.latched_pages_[i]->GetPageId() == node->GetPageId()) {
+      return i;
+    }
+  }
+  ASSERT(false, "Page is not latched by the operation.");
+  return 0;
 }
 
 /*
@@ -475,17 +800,21 @@ Page *BPlusTree::FindLeafPage(const GenericKey *key, page_id_t page_id, bool lef
  * @parameter: insert_record      default value is false. When set to true,
  * insert a record <index_name, current_page_id> into header page instead of
  * updating it.
+ * The record is inserted or updated whichever applies, an emptied tree keeps its record.
  */
 void BPlusTree::UpdateRootPageId(int insert_record) {
-  if(insert_record) {
-    IndexRootsPage *index_root_page = reinterpret_cast<IndexRootsPage*>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+  Page *page = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
+  page->WLatch();
+  auto *index_root_page = reinterpret_cast<IndexRootsPage *>(page->GetData());
+  if (insert_record) {
+    if (!index_root_page->Insert(index_id_, root_page_id_)) {
+      index_root_page->Update(index_id_, root_page_id_);
+    }
+  } else if (!index_root_page->Update(index_id_, root_page_id_)) {
     index_root_page->Insert(index_id_, root_page_id_);
-    buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
-  } else {
-    IndexRootsPage *index_root_page = reinterpret_cast<IndexRootsPage*>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
-    index_root_page->Update(index_id_, root_page_id_);
-    buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
   }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
 }
 
 /**
@@ -509,11 +838,14 @@ void BPlusTree::ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::ofstre
         << "max_size=" << leaf->GetMaxSize() << ",min_size=" << leaf->GetMinSize() << ",size=" << leaf->GetSize()
         << "</TD></TR>\n";
     out << "<TR>";
+    GenericKey *key = processor_.InitKey();
     for (int i = 0; i < leaf->GetSize(); i++) {
       Row ans;
-      processor_.DeserializeToKey(leaf->KeyAt(i), ans, schema);
+      leaf->KeyAt(i, key);
+      processor_.DeserializeToKey(key, ans, schema);
       out << "<TD>" << ans.GetField(0)->toString() << "</TD>\n";
     }
+    free(key);
     out << "</TR>";
     // Print table end
     out << "</TABLE>>];\n";
@@ -588,7 +920,7 @@ void BPlusTree::ToString(BPlusTreePage *page, BufferPoolManager *bpm) const {
     std::cout << "Leaf Page: " << leaf->GetPageId() << " parent: " << leaf->GetParentPageId()
               << " next: " << leaf->GetNextPageId() << std::endl;
     for (int i = 0; i < leaf->GetSize(); i++) {
-      std::cout << leaf->KeyAt(i) << ",";
+      std::cout << leaf->ValueAt(i).Get() << ",";
     }
     std::cout << std::endl;
     std::cout << std::endl;
@@ -1,17 +1,20 @@
 #include "index/b_plus_tree_index.h"
 
 #include "index/generic_key.h"
+#include "index/index_key_sorter.h"
+#include "storage/table_heap.h"
 #include "utils/tree_file_mgr.h"
 BPlusTreeIndex::BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, size_t key_size,
-                               BufferPoolManager *buffer_pool_manager)
-    : Index(index_id, key_schema),
-      processor_(key_schema_, key_size),
+                               BufferPoolManager *buffer_pool_manager, bool unique)
+    : Index(index_id, key_schema, unique),
+      processor_(key_schema_, key_size, unique),
       container_(index_id, buffer_pool_manager, processor_) {}
 
 dberr_t BPlusTreeIndex::InsertEntry(const Row &key, RowId row_id, Txn *txn) {
   // ASSERT(row_id.Get() != INVALID_ROWID.Get(), "Invalid row id for index insert.");
   GenericKey *index_key = processor_.InitKey();
   processor_.SerializeFromKey(index_key, key, key_schema_);
+  processor_.SetKeyRowId(index_key, row_id);
 
   bool status = container_.Insert(index_key, row_id, txn);
   free(index_key);
@@ -29,55 +32,104 @@ dberr_t BPlusTreeIndex::InsertEntry(const Row &key, RowId row_id, Txn *txn) {
 dberr_t BPlusTreeIndex::RemoveEntry(const Row &key, RowId row_id, Txn *txn) {
   GenericKey *index_key = processor_.InitKey();
   processor_.SerializeFromKey(index_key, key, key_schema_);
+  processor_.SetKeyRowId(index_key, row_id);
 
   container_.Remove(index_key, txn);
   free(index_key);
   return DB_SUCCESS;
 }
 
+/*
+ * Every operator but "=" on a unique index is answered by one or two range scans. NULL keys sort first and match no
+ * comparison, so the scans bounded only from above start right after them.
+ */
 dberr_t BPlusTreeIndex::ScanKey(const Row &key, vector<RowId> &result, Txn *txn, string compare_operator) {
-  GenericKey *index_key = processor_.InitKey();
-  processor_.SerializeFromKey(index_key, key, key_schema_);
-  auto end_iter = GetEndIterator();
-  if (compare_operator == "=") {
+  auto collect = [&result](std::unique_ptr<IndexRangeScan> scan) {
+    RowId row_id;
+    while (scan->Next(row_id)) {
+      result.emplace_back(row_id);
+    }
+  };
+  std::vector<Field> null_fields{Field(key_schema_->GetColumn(0)->GetType())};
+  Row null_key(null_fields);
+  if (compare_operator == "=" && processor_.IsUnique() && key.GetFieldCount() == key_schema_->GetColumnCount()) {
+    GenericKey *index_key = processor_.InitKey();
+    processor_.SerializeFromKey(index_key, key, key_schema_);
     container_.GetValue(index_key, result, txn);
+    free(index_key);
+  } else if (compare_operator == "=") {
+    collect(ScanRange(&key, true, &key, true, txn));
   } else if (compare_operator == ">") {
-    auto iter = GetBeginIterator(index_key);
-    if (container_.GetValue(index_key, result, txn)) ++iter;
-    result.clear();
-    for (; iter != end_iter; ++iter) {
-      result.emplace_back((*iter).second);
-    }
+    collect(ScanRange(&key, false, nullptr, false, txn));
   } else if (compare_operator == ">=") {
-    for (auto iter = GetBeginIterator(index_key); iter != end_iter; ++iter) {
-      result.emplace_back((*iter).second);
-    }
+    collect(ScanRange(&key, true, nullptr, false, txn));
   } else if (compare_operator == "<") {
-    auto stop_iter = GetBeginIterator(index_key);
-    for (auto iter = GetBeginIterator(); iter != stop_iter; ++iter) {
-      result.emplace_back((*iter).second);
-    }
+    collect(ScanRange(&null_key, false, &key, false, txn));
   } else if (compare_operator == "<=") {
-    auto stop_iter = GetBeginIterator(index_key);
-    for (auto iter = GetBeginIterator(); iter != stop_iter; ++iter) {
-      result.emplace_back((*iter).second);
-    }
-    container_.GetValue(index_key, result, txn);
+    collect(ScanRange(&null_key, false, &key, true, txn));
   } else if (compare_operator == "<>") {
-    for (auto iter = GetBeginIterator(); iter != end_iter; ++iter) {
-      result.emplace_back((*iter).second);
-    }
-    vector<RowId> temp;
-    if (container_.GetValue(index_key, temp, txn))
-      result.erase(find(result.begin(), result.end(), temp[0]));
+    collect(ScanRange(&null_key, false, &key, false, txn));
+    collect(ScanRange(&key, false, nullptr, false, txn));
   }
-  free(index_key);
   if (!result.empty())
     return DB_SUCCESS;
   else
     return DB_KEY_NOT_FOUND;
 }
 
+std::unique_ptr<IndexRangeScan> BPlusTreeIndex::ScanRange(const Row *low, bool low_inclusive, const Row *high,
+                                                          bool high_inclusive, Txn *txn) {
+  GenericKey *low_key = nullptr;
+  if (low != nullptr) {
+    low_key = processor_.InitKey();
+    // without a row id, the key sorts before all entries of a non-unique index with the same columns
+    processor_.SerializeFromKey(low_key, *low, key_schema_);
+    if (!low_inclusive) {
+      processor_.SetKeyUpperBound(low_key, processor_.GetPrefixSize(low->GetFieldCount()));
+    }
+  }
+  GenericKey *high_key = nullptr;
+  uint32_t high_size = 0;
+  if (high != nullptr) {
+    high_key = processor_.InitKey();
+    processor_.SerializeFromKey(high_key, *high, key_schema_);
+    high_size = processor_.GetPrefixSize(high->GetFieldCount());
+  }
+  return std::make_unique<BPlusTreeRangeScan>(processor_, container_, key_schema_, low_key, low_inclusive, high_key,
+                                              high_size, high_inclusive);
+}
+
+/*
+ * The rows are read once, their keys sorted and the tree built bottom-up. If the tree already has entries, the sorted
+ * entries are inserted one by one instead. Two rows with the same key in a unique index fail the build.
+ */
+dberr_t BPlusTreeIndex::BulkLoad(TableHeap *table_heap, Schema *table_schema, Txn *txn) {
+  IndexKeySorter sorter(processor_);
+  GenericKey *index_key = processor_.InitKey();
+  BufferAccessStrategy strategy;
+  for (auto iter = table_heap->Begin(txn, &strategy); iter != table_heap->End(); ++iter) {
+    Row key;
+    iter->GetKeyFromRow(table_schema, key_schema_, key);
+    processor_.SerializeFromKey(index_key, key, key_schema_);
+    processor_.SetKeyRowId(index_key, iter->GetRowId());
+    sorter.Add(index_key, iter->GetRowId());
+  }
+  free(index_key);
+  sorter.Sort();
+  dberr_t result = container_.BulkLoad(sorter);
+  if (result == DB_FAILED) {
+    result = DB_SUCCESS;
+    GenericKey *key;
+    RowId row_id;
+    while (result == DB_SUCCESS && sorter.Next(key, row_id)) {
+      if (!container_.Insert(key, row_id, txn)) {
+        result = DB_ALREADY_EXIST;
+      }
+    }
+  }
+  return result;
+}
+
 dberr_t BPlusTreeIndex::Destroy() {
   container_.Destroy();
   return DB_SUCCESS;
@@ -93,4 +145,82 @@ IndexIterator BPlusTreeIndex::GetBeginIterator(GenericKey *key) {
 
 IndexIterator BPlusTreeIndex::GetEndIterator() {
   return container_.End();
-}
\ No newline at end of file
+}
+BPlusTreeRangeScan::BPlusTreeRangeScan(const KeyManager &KM, BPlusTree &container, Schema *key_schema,
+                                       GenericKey *low, bool low_inclusive, GenericKey *high, uint32_t high_size,
+                                       bool high_inclusive)
+    : processor_(KM),
+      container_(container),
+      key_schema_(key_schema),
+      low_(low),
+      low_inclusive_(low_inclusive),
+      high_(high),
+      high_size_(high_size),
+      high_inclusive_(high_inclusive) {
+  batch_.reserve(INDEX_SCAN_BATCH_SIZE);
+  batch_keys_.reserve(INDEX_SCAN_BATCH_SIZE * processor_.GetKeySize());
+}
+
+BPlusTreeRangeScan::~BPlusTreeRangeScan() {
+  free(low_);
+  free(high_);
+}
+
+bool BPlusTreeRangeScan::Next(RowId &row_id) {
+  if (cursor_ == batch_.size()) {
+    if (exhausted_) {
+      return false;
+    }
+    ReadBatch();
+    if (batch_.empty()) {
+      return false;
+    }
+  }
+  row_id = batch_[cursor_++];
+  return true;
+}
+
+bool BPlusTreeRangeScan::Next(RowId &row_id, Row &key) {
+  if (!Next(row_id)) {
+    return false;
+  }
+  auto *key_buf = reinterpret_cast<const GenericKey *>(&batch_keys_[(cursor_ - 1) * processor_.GetKeySize()]);
+  processor_.DeserializeToKey(key_buf, key, key_schema_);
+  return true;
+}
+
+/*
+ * An exclusive low bound is either the last key of the previous batch, or a key past all entries with the bound
+ * columns (see ScanRange), so at most one entry equal to it is skipped.
+ */
+void BPlusTreeRangeScan::ReadBatch() {
+  batch_.clear();
+  batch_keys_.clear();
+  cursor_ = 0;
+  auto end_iter = container_.End();
+  auto iter = low_ == nullptr ? container_.Begin() : container_.Begin(low_);
+  if (low_ != nullptr && !low_inclusive_ && iter != end_iter && processor_.CompareKeys((*iter).first, low_) == 0) {
+    ++iter;
+  }
+  for (; iter != end_iter; ++iter) {
+    auto item = *iter;
+    if (high_ != nullptr) {
+      int cmp = processor_.CompareKeyPrefix(item.first, high_, high_size_);
+      if (cmp > 0 || (cmp == 0 && !high_inclusive_)) {
+        exhausted_ = true;
+        return;
+      }
+    }
+    batch_.emplace_back(item.second);
+    batch_keys_.insert(batch_keys_.end(), item.first->data, item.first->data + processor_.GetKeySize());
+    if (batch_.size() == static_cast<size_t>(INDEX_SCAN_BATCH_SIZE)) {
+      if (low_ == nullptr) {
+        low_ = processor_.InitKey();
+      }
+      memcpy(low_, item.first, processor_.GetKeySize());
+      low_inclusive_ = false;
+      return;
+    }
+  }
+  exhausted_ = true;
+}
@@ -0,0 +1,151 @@
+#include "index/generic_key.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+static inline void WriteBigEndian(char *buf, uint32_t value) {
+  buf[0] = static_cast<char>(value >> 24);
+  buf[1] = static_cast<char>(value >> 16);
+  buf[2] = static_cast<char>(value >> 8);
+  buf[3] = static_cast<char>(value);
+}
+
+static inline uint32_t ReadBigEndian(const char *buf) {
+  auto bytes = reinterpret_cast<const unsigned char *>(buf);
+  return (static_cast<uint32_t>(bytes[0]) << 24) | (static_cast<uint32_t>(bytes[1]) << 16) |
+         (static_cast<uint32_t>(bytes[2]) << 8) | static_cast<uint32_t>(bytes[3]);
+}
+
+/**
+ * Flip the sign bit of positive floats and all bits of negative floats, so that the bits order like the values.
+ */
+static inline uint32_t EncodeFloatBits(uint32_t bits) { return (bits & 0x80000000u) ? ~bits : bits ^ 0x80000000u; }
+
+static inline uint32_t DecodeFloatBits(uint32_t bits) { return (bits & 0x80000000u) ? bits ^ 0x80000000u : ~bits; }
+
+/**
+ * @return number of bytes a column takes in the key, without its null flag
+ */
+static inline uint32_t GetEncodedColumnSize(const Column *column) {
+  if (column->GetType() == TypeId::kTypeChar) {
+    return column->GetLength() + sizeof(uint32_t);
+  }
+  return Type::GetTypeSize(column->GetType());
+}
+
+uint32_t KeyManager::GetEncodedSize(Schema *key_schema) {
+  uint32_t size = 0;
+  for (auto column : key_schema->GetColumns()) {
+    size += 1 + GetEncodedColumnSize(column);
+  }
+  return size;
+}
+
+void KeyManager::SerializeFromKey(GenericKey *key_buf, const Row &key, Schema *schema) const {
+  ASSERT(key.GetFieldCount() <= schema->GetColumnCount(), "field nums not match.");
+  // initialize to 0, so that null columns and the padding compare equal
+  memset(key_buf->data, 0, key_size_);
+  char *buf = key_buf->data;
+  for (uint32_t i = 0; i < key.GetFieldCount(); i++) {
+    const Column *column = schema->GetColumn(i);
+    const Field *field = key.GetField(i);
+    uint32_t column_size = GetEncodedColumnSize(column);
+    ASSERT(buf + 1 + column_size <= key_buf->data + key_size_, "Index key size exceed max key size.");
+    if (field->IsNull()) {
+      buf += 1 + column_size;
+      continue;
+    }
+    *buf++ = 1;
+    switch (column->GetType()) {
+      case TypeId::kTypeInt: {
+        int32_t value;
+        field->SerializeTo(reinterpret_cast<char *>(&value));
+        WriteBigEndian(buf, static_cast<uint32_t>(value) ^ 0x80000000u);
+        break;
+      }
+      case TypeId::kTypeFloat: {
+        float value;
+        field->SerializeTo(reinterpret_cast<char *>(&value));
+        // -0.0 equals 0.0 and every NaN is alike, so each gets a single encoding
+        if (value == 0.0f) {
+          value = 0.0f;
+        } else if (std::isnan(value)) {
+          value = std::numeric_limits<float>::quiet_NaN();
+        }
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(float));
+        WriteBigEndian(buf, EncodeFloatBits(bits));
+        break;
+      }
+      case TypeId::kTypeChar: {
+        uint32_t len = field->GetLength();
+        // a search value longer than the column keeps its full length after the bytes that fit, so it sorts after
+        // every stored value it starts with and matches none of them
+        memcpy(buf, field->GetData(), std::min(len, column->GetLength()));
+        // the length breaks ties between strings that only differ by trailing zero bytes, like CompareStrings does
+        WriteBigEndian(buf + column->GetLength(), len);
+        break;
+      }
+      default:
+        ASSERT(false, "Unsupported key type.");
+    }
+    buf += column_size;
+  }
+}
+
+void KeyManager::DeserializeToKey(const GenericKey *key_buf, Row &key, Schema *schema) const {
+  ASSERT(key.GetFieldCount() == 0, "Non empty field in row.");
+  std::vector<Field *> &fields = key.GetFields();
+  const char *buf = key_buf->data;
+  for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+    const Column *column = schema->GetColumn(i);
+    uint32_t column_size = GetEncodedColumnSize(column);
+    bool is_null = *buf++ == 0;
+    if (is_null) {
+      fields.push_back(new Field(column->GetType()));
+      buf += column_size;
+      continue;
+    }
+    switch (column->GetType()) {
+      case TypeId::kTypeInt:
+        fields.push_back(new Field(TypeId::kTypeInt, static_cast<int32_t>(ReadBigEndian(buf) ^ 0x80000000u)));
+        break;
+      case TypeId::kTypeFloat: {
+        uint32_t bits = DecodeFloatBits(ReadBigEndian(buf));
+        float value;
+        memcpy(&value, &bits, sizeof(float));
+        fields.push_back(new Field(TypeId::kTypeFloat, value));
+        break;
+      }
+      case TypeId::kTypeChar:
+        fields.push_back(new Field(TypeId::kTypeChar, const_cast<char *>(buf),
+                                   std::min(ReadBigEndian(buf + column->GetLength()), column->GetLength()), true));
+        break;
+      default:
+        ASSERT(false, "Unsupported key type.");
+    }
+    buf += column_size;
+  }
+}
+
+void KeyManager::SetKeyRowId(GenericKey *key_buf, const RowId &rid) const {
+  if (unique_) {
+    return;
+  }
+  WriteBigEndian(key_buf->data + column_size_, static_cast<uint32_t>(rid.GetPageId()) ^ 0x80000000u);
+  WriteBigEndian(key_buf->data + column_size_ + sizeof(uint32_t), rid.GetSlotNum());
+}
+
+void KeyManager::SetKeyUpperBound(GenericKey *key_buf, uint32_t prefix_size) const {
+  ASSERT(prefix_size <= encoded_size_, "Key prefix exceeds the key.");
+  memset(key_buf->data + prefix_size, 0xff, encoded_size_ - prefix_size);
+}
+
+uint32_t KeyManager::GetPrefixSize(uint32_t column_count) const {
+  uint32_t size = 0;
+  for (uint32_t i = 0; i < column_count; i++) {
+    size += 1 + GetEncodedColumnSize(key_schema_->GetColumn(i));
+  }
+  return size;
+}
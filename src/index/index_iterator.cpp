@@ -5,14 +5,45 @@
 
 IndexIterator::IndexIterator() = default;
 
-IndexIterator::IndexIterator(page_id_t page_id, BufferPoolManager *bpm, int index)
-    : current_page_id(page_id), item_index(index), buffer_pool_manager(bpm) {
-  if(current_page_id!=INVALID_PAGE_ID)page = reinterpret_cast<LeafPage *>(buffer_pool_manager->FetchPage(current_page_id)->GetData());
+IndexIterator::IndexIterator(Page *page, BufferPoolManager *bpm, int index)
+    : current_page_id(page->GetPageId()),
+      current_page(page),
+      page(reinterpret_cast<LeafPage *>(page->GetData())),
+      item_index(index),
+      buffer_pool_manager(bpm) {
+  SkipToItem();
+}
+
+IndexIterator::IndexIterator(IndexIterator &&other) noexcept
+    : current_page_id(other.current_page_id),
+      current_page(other.current_page),
+      page(other.page),
+      item_index(other.item_index),
+      buffer_pool_manager(other.buffer_pool_manager),
+      key(other.key) {
+  other.current_page_id = INVALID_PAGE_ID;
+  other.current_page = nullptr;
+  other.page = nullptr;
+  other.item_index = 0;
+  other.key = nullptr;
+}
+
+IndexIterator &IndexIterator::operator=(IndexIterator &&other) noexcept {
+  if (this != &other) {
+    Release();
+    std::swap(current_page_id, other.current_page_id);
+    std::swap(current_page, other.current_page);
+    std::swap(page, other.page);
+    std::swap(item_index, other.item_index);
+    std::swap(buffer_pool_manager, other.buffer_pool_manager);
+    std::swap(key, other.key);
+  }
+  return *this;
 }
 
 IndexIterator::~IndexIterator() {
-  if (current_page_id != INVALID_PAGE_ID)
-    buffer_pool_manager->UnpinPage(current_page_id, false);
+  Release();
+  free(key);
 }
 
 /**
@@ -22,7 +53,10 @@ std::pair<GenericKey *, RowId> IndexIterator::operator*() {
   if(current_page_id == INVALID_PAGE_ID || page == nullptr || item_index >= page->GetSize()) {
     return {nullptr, RowId()};
   }
-  return page->GetItem(item_index);
+  if (key == nullptr) {
+    key = reinterpret_cast<GenericKey *>(malloc(page->GetKeySize()));
+  }
+  return page->GetItem(item_index, key);
 }
 
 /**
@@ -32,21 +66,8 @@ IndexIterator &IndexIterator::operator++() {
   if(current_page_id == INVALID_PAGE_ID || page == nullptr) {
     return *this;
   }
-  if(item_index == (page->GetSize() - 1)) {
-    // Move to next page
-    if (page->GetNextPageId() != INVALID_PAGE_ID) {
-      buffer_pool_manager->UnpinPage(current_page_id, false);
-      current_page_id = page->GetNextPageId();
-      page = reinterpret_cast<LeafPage *>(buffer_pool_manager->FetchPage(current_page_id)->GetData());
-      item_index = 0;
-    } else {
-      current_page_id = INVALID_PAGE_ID;
-      page = nullptr;
-      item_index = 0;
-    }
-  } else {
-    item_index+=1;
-  }
+  item_index++;
+  SkipToItem();
   return *this;
 }
 
@@ -56,4 +77,36 @@ bool IndexIterator::operator==(const IndexIterator &itr) const {
 
 bool IndexIterator::operator!=(const IndexIterator &itr) const {
   return !(*this == itr);
-}
\ No newline at end of file
+}
+
+/*
+ * Leaves are only ever latched left to right while walking the chain, writers that latch two leaves do the same.
+ */
+void IndexIterator::SkipToItem() {
+  while (page != nullptr && item_index >= page->GetSize()) {
+    page_id_t next_page_id = page->GetNextPageId();
+    if (next_page_id == INVALID_PAGE_ID) {
+      Release();
+      return;
+    }
+    Page *next_page = buffer_pool_manager->FetchPage(next_page_id);
+    next_page->RLatch();
+    current_page->RUnlatch();
+    buffer_pool_manager->UnpinPage(current_page_id, false);
+    current_page_id = next_page_id;
+    current_page = next_page;
+    page = reinterpret_cast<LeafPage *>(next_page->GetData());
+    item_index = 0;
+  }
+}
+
+void IndexIterator::Release() {
+  if (current_page != nullptr) {
+    current_page->RUnlatch();
+    buffer_pool_manager->UnpinPage(current_page_id, false);
+  }
+  current_page_id = INVALID_PAGE_ID;
+  current_page = nullptr;
+  page = nullptr;
+  item_index = 0;
+}
@@ -0,0 +1,132 @@
+#include "index/index_key_sorter.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "glog/logging.h"
+
+IndexKeySorter::IndexKeySorter(const KeyManager &KM, size_t memory_limit)
+    : key_manager_(KM),
+      key_size_(KM.GetKeySize()),
+      entry_size_(KM.GetKeySize() + sizeof(RowId)),
+      memory_limit_(std::max(memory_limit, KM.GetKeySize() + sizeof(RowId))) {}
+
+IndexKeySorter::~IndexKeySorter() {
+  for (auto &run : runs_) {
+    fclose(run.file_);
+  }
+}
+
+void IndexKeySorter::Add(const GenericKey *key, RowId rid) {
+  if (buffer_.size() + entry_size_ > memory_limit_) {
+    SpillRun();
+  }
+  auto *key_data = reinterpret_cast<const char *>(key);
+  auto *rid_data = reinterpret_cast<const char *>(&rid);
+  buffer_.insert(buffer_.end(), key_data, key_data + key_size_);
+  buffer_.insert(buffer_.end(), rid_data, rid_data + sizeof(RowId));
+  entry_count_++;
+}
+
+void IndexKeySorter::Sort() {
+  if (runs_.empty()) {
+    SortBuffer();
+    return;
+  }
+  if (!buffer_.empty()) {
+    SpillRun();
+  }
+  for (size_t i = 0; i < runs_.size(); i++) {
+    rewind(runs_[i].file_);
+    runs_[i].current_.resize(entry_size_);
+    if (ReadRun(runs_[i])) {
+      heap_.push_back(i);
+    }
+  }
+  auto greater = [this](size_t lhs, size_t rhs) { return RunGreater(lhs, rhs); };
+  std::make_heap(heap_.begin(), heap_.end(), greater);
+}
+
+bool IndexKeySorter::Next(GenericKey *&key, RowId &rid) {
+  const char *entry;
+  if (runs_.empty()) {
+    if (next_sorted_ == sorted_.size()) {
+      return false;
+    }
+    entry = sorted_[next_sorted_++];
+  } else {
+    if (heap_.empty()) {
+      return false;
+    }
+    auto greater = [this](size_t lhs, size_t rhs) { return RunGreater(lhs, rhs); };
+    std::pop_heap(heap_.begin(), heap_.end(), greater);
+    Run &run = runs_[heap_.back()];
+    entry_.swap(run.current_);
+    run.current_.resize(entry_size_);
+    if (ReadRun(run)) {
+      std::push_heap(heap_.begin(), heap_.end(), greater);
+    } else {
+      heap_.pop_back();
+    }
+    entry = entry_.data();
+  }
+  key = reinterpret_cast<GenericKey *>(const_cast<char *>(entry));
+  memcpy(&rid, entry + key_size_, sizeof(RowId));
+  return true;
+}
+
+bool IndexKeySorter::Less(const char *lhs, const char *rhs) const {
+  int cmp =
+      key_manager_.CompareKeys(reinterpret_cast<const GenericKey *>(lhs), reinterpret_cast<const GenericKey *>(rhs));
+  if (cmp != 0) {
+    return cmp < 0;
+  }
+  RowId lhs_rid, rhs_rid;
+  memcpy(&lhs_rid, lhs + key_size_, sizeof(RowId));
+  memcpy(&rhs_rid, rhs + key_size_, sizeof(RowId));
+  return lhs_rid.Get() < rhs_rid.Get();
+}
+
+bool IndexKeySorter::RunGreater(size_t lhs, size_t rhs) const {
+  return Less(runs_[rhs].current_.data(), runs_[lhs].current_.data());
+}
+
+void IndexKeySorter::SortBuffer() {
+  sorted_.clear();
+  sorted_.reserve(buffer_.size() / entry_size_);
+  for (size_t offset = 0; offset < buffer_.size(); offset += entry_size_) {
+    sorted_.push_back(buffer_.data() + offset);
+  }
+  std::sort(sorted_.begin(), sorted_.end(), [this](const char *lhs, const char *rhs) { return Less(lhs, rhs); });
+  next_sorted_ = 0;
+}
+
+void IndexKeySorter::SpillRun() {
+  FILE *file = tmpfile();
+  if (file == nullptr) {
+    LOG(ERROR) << "Failed to create a temporary file for sorting index keys.";
+    throw std::runtime_error("Failed to create a temporary file");
+  }
+  SortBuffer();
+  for (const char *entry : sorted_) {
+    if (fwrite(entry, entry_size_, 1, file) != 1) {
+      fclose(file);
+      LOG(ERROR) << "Failed to write sorted index keys to a temporary file.";
+      throw std::runtime_error("Failed to write a temporary file");
+    }
+  }
+  runs_.push_back({file, {}});
+  buffer_.clear();
+  sorted_.clear();
+}
+
+bool IndexKeySorter::ReadRun(Run &run) {
+  if (fread(run.current_.data(), entry_size_, 1, run.file_) == 1) {
+    return true;
+  }
+  if (ferror(run.file_)) {
+    LOG(ERROR) << "Failed to read sorted index keys from a temporary file.";
+    throw std::runtime_error("Failed to read a temporary file");
+  }
+  return false;
+}
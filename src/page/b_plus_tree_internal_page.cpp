@@ -3,9 +3,9 @@
 #include "index/generic_key.h"
 
 #define pairs_off (data_)
-#define pair_size (GetKeySize() + sizeof(page_id_t))
+#define pair_size (key_length_ + sizeof(page_id_t))
 #define key_off 0
-#define val_off GetKeySize()
+#define val_off key_length_
 
 /**
  * TODO: Student Implement
@@ -18,9 +18,10 @@
  * Including set page type, set current size, set page id, set parent id and set
  * max page size
  */
-void InternalPage::Init(page_id_t page_id, page_id_t parent_id, int key_size, int max_size) {
+void InternalPage::Init(page_id_t page_id, page_id_t parent_id, int key_size, int max_size, int key_length) {
   SetPageId(page_id);
   SetParentPageId(parent_id);
+  key_length_ = key_length == UNDEFINED_SIZE ? key_size : key_length;
   if(max_size==UNDEFINED_SIZE) SetMaxSize((PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / pair_size);
   else SetMaxSize(max_size);
   SetKeySize(key_size);
@@ -37,7 +38,7 @@ GenericKey *InternalPage::KeyAt(int index) {
 }
 
 void InternalPage::SetKeyAt(int index, GenericKey *key) {
-  memcpy(pairs_off + index * pair_size + key_off, key, GetKeySize());
+  memcpy(pairs_off + index * pair_size + key_off, key, key_length_);
 }
 
 page_id_t InternalPage::ValueAt(int index) const {
@@ -61,7 +62,7 @@ void *InternalPage::PairPtrAt(int index) {
 }
 
 void InternalPage::PairCopy(void *dest, void *src, int pair_num) {
-  memcpy(dest, src, pair_num * (GetKeySize() + sizeof(page_id_t)));
+  memcpy(dest, src, pair_num * pair_size);
 }
 /*****************************************************************************
  * LOOKUP
@@ -73,15 +74,23 @@ void InternalPage::PairCopy(void *dest, void *src, int pair_num) {
  * 用了二分查找
  */
 page_id_t InternalPage::Lookup(const GenericKey *key, const KeyManager &KM) {
+  // number of keys from the second one on that are <= key
+  if (key_length_ == GetKeySize()) {
+    int index = FixedKeySearch<sizeof(page_id_t)>(pairs_off + pair_size, GetSize() - 1, key, true, KM);
+    if (index >= 0) {
+      return ValueAt(index);
+    }
+  }
   int left,right,mid;
   left = 0;
   right = GetSize()-1;
   while(left < right){
     mid = (left + right + 1) / 2;
     if(mid==0) return ValueAt(0);
-    if(KM.CompareKeys(KeyAt(mid),key) == 0){
+    int cmp = KM.CompareKeys(KeyAt(mid),key);
+    if(cmp == 0){
       return ValueAt(mid);
-    }else if(KM.CompareKeys(KeyAt(mid),key) < 0){
+    }else if(cmp < 0){
       left = mid;
     }else{
       right = mid - 1;
@@ -100,7 +109,10 @@ page_id_t InternalPage::Lookup(const GenericKey *key, const KeyManager &KM) {
  * NOTE: This method is only called within InsertIntoParent()(b_plus_tree.cpp)
  */
 void InternalPage::PopulateNewRoot(const page_id_t &old_value, GenericKey *new_key, const page_id_t &new_value) {
-  InsertNodeAfter(old_value, new_key, new_value);
+  SetValueAt(0, old_value);
+  SetKeyAt(1, new_key);
+  SetValueAt(1, new_value);
+  SetSize(2);
   SetLSN(INVALID_LSN);
 }
 
@@ -128,6 +140,7 @@ int InternalPage::InsertNodeAfter(const page_id_t &old_value, GenericKey *new_ke
       return GetSize();
     }
   }
+  return GetSize();
 }
 
 /*****************************************************************************
@@ -138,12 +151,10 @@ int InternalPage::InsertNodeAfter(const page_id_t &old_value, GenericKey *new_ke
  * buffer_pool_manager 是干嘛的？传给CopyNFrom()用于Fetch数据页
  */
 void InternalPage::MoveHalfTo(InternalPage *recipient, BufferPoolManager *buffer_pool_manager) {
+  // the first key of the recipient is the one to push up into the parent
   int half = (GetSize() + 1) / 2;
   recipient->CopyNFrom(pairs_off + half * pair_size, GetSize() - half, buffer_pool_manager);
   SetSize(half);
-  recipient->SetParentPageId(GetParentPageId());
-  recipient->SetPageType(IndexPageType::INTERNAL_PAGE);
-  recipient->SetSize(GetSize() - half);
 }
 
 /* Copy entries into me, starting from {items} and copy {size} entries.
@@ -188,8 +199,6 @@ void InternalPage::Remove(int index) {
 page_id_t InternalPage::RemoveAndReturnOnlyChild() {
   page_id_t child_page_id = ValueAt(0);
   SetSize(0);
-  SetKeyAt(0, nullptr);
-  SetValueAt(0, INVALID_PAGE_ID);
   return child_page_id;
 }
 
@@ -204,13 +213,9 @@ page_id_t InternalPage::RemoveAndReturnOnlyChild() {
  * pages that are moved to the recipient
  */
 void InternalPage::MoveAllTo(InternalPage *recipient, GenericKey *middle_key, BufferPoolManager *buffer_pool_manager) {
-  recipient->CopyLastFrom(middle_key, GetParentPageId(), buffer_pool_manager);
-  // BPlusTreeInternalPage* parent_page = reinterpret_cast<BPlusTreeInternalPage*>(buffer_pool_manager->FetchPage(GetParentPageId()));
-  // parent_page->Remove(ValueIndex(GetPageId()));
-  for(auto i=0;i<GetSize();i++){
-    recipient->CopyLastFrom(KeyAt(i),ValueAt(i),buffer_pool_manager);
-  }
-
+  SetKeyAt(0, middle_key);
+  recipient->CopyNFrom(pairs_off, GetSize(), buffer_pool_manager);
+  SetSize(0);
 }
 
 /*****************************************************************************
@@ -226,16 +231,9 @@ void InternalPage::MoveAllTo(InternalPage *recipient, GenericKey *middle_key, Bu
  */
 void InternalPage::MoveFirstToEndOf(InternalPage *recipient, GenericKey *middle_key,
                                     BufferPoolManager *buffer_pool_manager) {
-  InternalPage *parent_page = reinterpret_cast<InternalPage *>(buffer_pool_manager->FetchPage(GetParentPageId()));
-  parent_page->SetKeyAt(ValueIndex(GetPageId()), middle_key);
-  recipient->CopyLastFrom(KeyAt(0), ValueAt(0), buffer_pool_manager);
-  for(auto i=0;i<GetSize()-1;i++){
-    SetKeyAt(i,KeyAt(i+1));
-    SetValueAt(i,ValueAt(i+1));
-  }
-  SetSize(GetSize()-1);
-  SetKeyAt(GetSize(), nullptr);
-  SetValueAt(GetSize(), INVALID_PAGE_ID);
+  // my first key is unused, the new separator is left there for the caller
+  recipient->CopyLastFrom(middle_key, ValueAt(0), buffer_pool_manager);
+  Remove(0);
 }
 
 /* Append an entry at the end.
@@ -260,12 +258,12 @@ void InternalPage::CopyLastFrom(GenericKey *key, const page_id_t value, BufferPo
  */
 void InternalPage::MoveLastToFrontOf(InternalPage *recipient, GenericKey *middle_key,
                                      BufferPoolManager *buffer_pool_manager) {
-  InternalPage *parent_page = reinterpret_cast<InternalPage *>(buffer_pool_manager->FetchPage(GetParentPageId()));
-  parent_page->SetKeyAt(ValueIndex(GetPageId()), middle_key);
-  recipient->CopyFirstFrom(ValueAt(GetSize()-1), buffer_pool_manager);
-  SetSize(GetSize()-1);
-  SetKeyAt(GetSize(), nullptr);
-  SetValueAt(GetSize(), INVALID_PAGE_ID);
+  // the unused first key of the recipient becomes the separator of its old first child, and the new separator is
+  // left in its place for the caller
+  recipient->SetKeyAt(0, middle_key);
+  recipient->CopyFirstFrom(ValueAt(GetSize() - 1), buffer_pool_manager);
+  recipient->SetKeyAt(0, KeyAt(GetSize() - 1));
+  SetSize(GetSize() - 1);
 }
 
 /* Append an entry at the beginning.
@@ -277,7 +275,6 @@ void InternalPage::CopyFirstFrom(const page_id_t value, BufferPoolManager *buffe
     SetKeyAt(i,KeyAt(i-1));
     SetValueAt(i,ValueAt(i-1));
   }
-  SetKeyAt(0, nullptr);
   SetValueAt(0, value);
   IncreaseSize(1);
   BPlusTreePage *child_page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager->FetchPage(value));
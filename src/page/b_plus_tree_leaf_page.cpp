@@ -1,13 +1,11 @@
 #include "page/b_plus_tree_leaf_page.h"
 
 #include <algorithm>
+#include <string>
 
 #include "index/generic_key.h"
 
-#define pairs_off (data_)
-#define pair_size (GetKeySize() + sizeof(RowId))
-#define key_off 0
-#define val_off GetKeySize()
+#define AsKey(data) reinterpret_cast<const GenericKey *>(data)
 /*****************************************************************************
  * HELPER METHODS AND UTILITIES
  *****************************************************************************/
@@ -21,16 +19,21 @@
  * next page id and set max size
  * 未初始化next_page_id
  */
-void LeafPage::Init(page_id_t page_id, page_id_t parent_id, int key_size, int max_size) {
+void LeafPage::Init(page_id_t page_id, page_id_t parent_id, int key_size, int max_size, int key_length) {
   SetPageId(page_id);
   SetParentPageId(parent_id);
-  if(max_size==UNDEFINED_SIZE) SetMaxSize((PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / pair_size);
-  else SetMaxSize(max_size);
   SetKeySize(key_size);
   SetPageType(IndexPageType::LEAF_PAGE);
   SetSize(0);
   SetLSN(INVALID_LSN);
   SetNextPageId(INVALID_PAGE_ID);
+  // 8 byte keys stay whole, so that the pairs keep the stride SearchWordKeys expects
+  key_length_ = key_length == UNDEFINED_SIZE || key_size == static_cast<int>(sizeof(uint64_t)) ? key_size : key_length;
+  prefix_size_ = 0;
+  size_limit_ = max_size;
+  memset(LowFence(), 0, key_length_);
+  memset(HighFence(), 0xff, key_length_);
+  SetMaxSize(MaxSizeFor(prefix_size_));
 }
 
 /**
@@ -47,6 +50,72 @@ void LeafPage::SetNextPageId(page_id_t next_page_id) {
   }
 }
 
+int LeafPage::GetMinSize() const { return MaxSizeFor(0) / 2; }
+
+int LeafPage::GetMaxSizeUpTo(const GenericKey *high_key) const {
+  return MaxSizeFor(CommonPrefixSize(LowFence(), high_key->data));
+}
+
+int LeafPage::GetMergedMaxSize(const LeafPage *right) const {
+  return MaxSizeFor(CommonPrefixSize(LowFence(), right->HighFence()));
+}
+
+void LeafPage::GetLowKey(GenericKey *key) const {
+  memcpy(key->data, LowFence(), key_length_);
+  memset(key->data + key_length_, 0, GetKeySize() - key_length_);
+}
+
+/*
+ * The fences may be taken from this page, so the old prefix is saved before they are overwritten.
+ */
+void LeafPage::SetKeyRange(const GenericKey *low_key, const GenericKey *high_key) {
+  int old_prefix_size = prefix_size_;
+  int old_pair_size = PairSize();
+  int prefix_size = CommonPrefixSize(low_key->data, high_key->data);
+  std::string old_prefix;
+  if (prefix_size < old_prefix_size) {
+    old_prefix.assign(LowFence(), old_prefix_size);
+  }
+  memmove(LowFence(), low_key->data, key_length_);
+  memmove(HighFence(), high_key->data, key_length_);
+  prefix_size_ = prefix_size;
+  int pair_size = PairSize();
+  char *pairs = PairAt(0);
+  if (prefix_size > old_prefix_size) {
+    // the pairs shrink, move them front to back
+    for (int i = 0; i < GetSize(); i++) {
+      memmove(pairs + i * pair_size, pairs + i * old_pair_size + (prefix_size - old_prefix_size), pair_size);
+    }
+  } else if (prefix_size < old_prefix_size) {
+    // the pairs grow, move them back to front and put the bytes that left the prefix in front of them
+    int grow = old_prefix_size - prefix_size;
+    for (int i = GetSize() - 1; i >= 0; i--) {
+      memmove(pairs + i * pair_size + grow, pairs + i * old_pair_size, old_pair_size);
+      memcpy(pairs + i * pair_size, old_prefix.data() + prefix_size, grow);
+    }
+  }
+  SetMaxSize(MaxSizeFor(prefix_size_));
+}
+
+void LeafPage::SetHighKey(const GenericKey *high_key) { SetKeyRange(AsKey(LowFence()), high_key); }
+
+int LeafPage::CommonPrefixSize(const char *low, const char *high) const {
+  if (GetKeySize() == static_cast<int>(sizeof(uint64_t))) {
+    return 0;
+  }
+  int size = 0;
+  while (size < key_length_ && low[size] == high[size]) {
+    size++;
+  }
+  return size;
+}
+
+int LeafPage::MaxSizeFor(int prefix_size) const {
+  int max_size = (static_cast<int>(sizeof(data_)) - 2 * key_length_) /
+                 (key_length_ - prefix_size + static_cast<int>(sizeof(RowId)));
+  return size_limit_ == UNDEFINED_SIZE ? max_size : std::min(max_size, size_limit_);
+}
+
 /**
  * TODO: Student Implement
  */
@@ -55,15 +124,29 @@ void LeafPage::SetNextPageId(page_id_t next_page_id) {
  * NOTE: This method is only used when generating index iterator
  * 二分查找
  */
-int LeafPage::KeyIndex(const GenericKey *key, const KeyManager &KM) {
+int LeafPage::KeyIndex(const GenericKey *key, const KeyManager &KM) const {
+  if (prefix_size_ == 0 && key_length_ == GetKeySize()) {
+    int index = FixedKeySearch<sizeof(RowId)>(PairAt(0), GetSize(), key, false, KM);
+    if (index >= 0) {
+      return index;
+    }
+  }
+  // all keys of the page share the prefix, a key with another prefix goes before or after all of them
+  int cmp = memcmp(key->data, LowFence(), prefix_size_);
+  if (cmp != 0) {
+    return cmp < 0 ? 0 : GetSize();
+  }
+  const char *suffix = key->data + prefix_size_;
+  int suffix_size = key_length_ - prefix_size_;
   int left,right,mid;
   left = 0;
   right = GetSize();
   while(left < right){
     mid = (left + right) / 2;
-    if(KM.CompareKeys(KeyAt(mid),key) == 0){
+    cmp = memcmp(PairAt(mid), suffix, suffix_size);
+    if(cmp == 0){
       return mid;
-    }else if(KM.CompareKeys(KeyAt(mid),key) < 0){
+    }else if(cmp < 0){
       left = mid + 1;
     }else{
       right = mid;
@@ -76,34 +159,46 @@ int LeafPage::KeyIndex(const GenericKey *key, const KeyManager &KM) {
  * Helper method to find and return the key associated with input "index"(a.k.a
  * array offset)
  */
-GenericKey *LeafPage::KeyAt(int index) {
-  return reinterpret_cast<GenericKey *>(pairs_off + index * pair_size + key_off);
+void LeafPage::KeyAt(int index, GenericKey *key) const {
+  CopyKeyAt(index, key->data);
+  memset(key->data + key_length_, 0, GetKeySize() - key_length_);
 }
 
-void LeafPage::SetKeyAt(int index, GenericKey *key) {
-  memcpy(pairs_off + index * pair_size + key_off, key, GetKeySize());
+void LeafPage::CopyKeyAt(int index, char *key) const {
+  memcpy(key, LowFence(), prefix_size_);
+  memcpy(key + prefix_size_, PairAt(index), key_length_ - prefix_size_);
 }
 
-RowId LeafPage::ValueAt(int index) const {
-  return *reinterpret_cast<const RowId *>(pairs_off + index * pair_size + val_off);
+void LeafPage::SetKeyAt(int index, const GenericKey *key) {
+  memcpy(PairAt(index), key->data + prefix_size_, key_length_ - prefix_size_);
 }
 
-void LeafPage::SetValueAt(int index, RowId value) {
-  *reinterpret_cast<RowId *>(pairs_off + index * pair_size + val_off) = value;
+int LeafPage::CompareKeyAt(int index, const GenericKey *key) const {
+  int cmp = memcmp(LowFence(), key->data, prefix_size_);
+  if (cmp != 0) {
+    return cmp;
+  }
+  return memcmp(PairAt(index), key->data + prefix_size_, key_length_ - prefix_size_);
 }
 
-void *LeafPage::PairPtrAt(int index) {
-  return KeyAt(index);
+RowId LeafPage::ValueAt(int index) const {
+  RowId value;
+  memcpy(&value, PairAt(index) + key_length_ - prefix_size_, sizeof(RowId));
+  return value;
 }
 
-void LeafPage::PairCopy(void *dest, void *src, int pair_num) {
-  memcpy(dest, src, pair_num * (GetKeySize() + sizeof(RowId)));
+void LeafPage::SetValueAt(int index, RowId value) {
+  memcpy(PairAt(index) + key_length_ - prefix_size_, &value, sizeof(RowId));
 }
+
 /*
  * Helper method to find and return the key & value pair associated with input
  * "index"(a.k.a. array offset)
  */
-std::pair<GenericKey *, RowId> LeafPage::GetItem(int index) { return {KeyAt(index), ValueAt(index)}; }
+std::pair<GenericKey *, RowId> LeafPage::GetItem(int index, GenericKey *key) const {
+  KeyAt(index, key);
+  return {key, ValueAt(index)};
+}
 
 /*****************************************************************************
  * INSERTION
@@ -118,13 +213,10 @@ int LeafPage::Insert(GenericKey *key, const RowId &value, const KeyManager &KM)
   if (GetSize() > GetMaxSize()){
     return -1;
   }
-  if (index < GetSize() && KM.CompareKeys(KeyAt(index), key) == 0) {
+  if (index < GetSize() && CompareKeyAt(index, key) == 0) {
     return GetSize();
   }
-  for (int i = GetSize(); i > index; i--) {
-    SetKeyAt(i, KeyAt(i - 1));
-    SetValueAt(i, ValueAt(i - 1));
-  }
+  memmove(PairAt(index + 1), PairAt(index), (GetSize() - index) * PairSize());
   SetKeyAt(index, key);
   SetValueAt(index, value);
   IncreaseSize(1);
@@ -136,22 +228,45 @@ int LeafPage::Insert(GenericKey *key, const RowId &value, const KeyManager &KM)
  *****************************************************************************/
 /*
  * Remove half of key & value pairs from this page to "recipient" page
+ * The first key moved separates the two pages and becomes the low key of recipient.
  */
 void LeafPage::MoveHalfTo(LeafPage *recipient) {
   int half = (GetSize() + 1) / 2;
-  int reci_half = GetSize() - half;
-  recipient->CopyNFrom(pairs_off + half * pair_size, GetSize() - half);
+  std::string separator(key_length_, '\0');
+  CopyKeyAt(half, separator.data());
+  recipient->SetKeyRange(AsKey(separator.data()), AsKey(HighFence()));
+  recipient->CopyNFrom(this, half, GetSize() - half);
   SetSize(half);
-  SetNextPageId(recipient->GetPageId());
-  recipient->SetSize(reci_half);
+  SetHighKey(AsKey(separator.data()));
 }
 
 /*
  * Copy starting from items, and copy {size} number of elements into me.
  */
-void LeafPage::CopyNFrom(void *src, int size) {
-  int old_size = GetSize();
-  memcpy(pairs_off + old_size * pair_size, src, size * pair_size);
+void LeafPage::CopyNFrom(const LeafPage *src, int src_index, int size) {
+  if (src->prefix_size_ == prefix_size_) {
+    memcpy(PairAt(GetSize()), src->PairAt(src_index), size * PairSize());
+  } else {
+    for (int i = 0; i < size; i++) {
+      CopyPairFrom(src, src_index + i, GetSize() + i);
+    }
+  }
+  IncreaseSize(size);
+}
+
+/*
+ * The key of src is within the range of this page. If this page has the longer prefix, the pair loses the head of its
+ * suffix, otherwise the pair gets the bytes between the two prefixes from the low key of src.
+ */
+void LeafPage::CopyPairFrom(const LeafPage *src, int src_index, int index) {
+  const char *pair = src->PairAt(src_index);
+  if (prefix_size_ >= src->prefix_size_) {
+    memcpy(PairAt(index), pair + prefix_size_ - src->prefix_size_, PairSize());
+  } else {
+    int grow = src->prefix_size_ - prefix_size_;
+    memcpy(PairAt(index), src->LowFence() + prefix_size_, grow);
+    memcpy(PairAt(index) + grow, pair, src->PairSize());
+  }
 }
 
 /*****************************************************************************
@@ -162,20 +277,11 @@ void LeafPage::CopyNFrom(void *src, int size) {
  * does, then store its corresponding value in input "value" and return true.
  * If the key does not exist, then return false
  */
-bool LeafPage::Lookup(const GenericKey *key, RowId &value, const KeyManager &KM) {
-  int left,right;
-  left = 0;
-  right = GetSize()-1;
-  while(left <= right){
-    int mid = (left + right) / 2;
-    if(KM.CompareKeys(KeyAt(mid),key) == 0){
-      value = ValueAt(mid);
-      return true;
-    }else if(KM.CompareKeys(KeyAt(mid),key) < 0){
-      left = mid + 1;
-    }else{
-      right = mid - 1;
-    }
+bool LeafPage::Lookup(const GenericKey *key, RowId &value, const KeyManager &KM) const {
+  int index = KeyIndex(key, KM);
+  if (index < GetSize() && CompareKeyAt(index, key) == 0) {
+    value = ValueAt(index);
+    return true;
   }
   return false;
 }
@@ -190,19 +296,13 @@ bool LeafPage::Lookup(const GenericKey *key, RowId &value, const KeyManager &KM)
  * @return  page size after deletion
  */
 int LeafPage::RemoveAndDeleteRecord(const GenericKey *key, const KeyManager &KM) {
-  RowId value;
-  if (!Lookup(key, value, KM)) {
+  int index = KeyIndex(key, KM);
+  if (index >= GetSize() || CompareKeyAt(index, key) != 0) {
     LOG(INFO)<<"Dont find key in leaf page "<<GetPageId();
     return -1;
   }
-  int index = KeyIndex(key, KM);
-  for (int i = index; i < GetSize() - 1; i++) {
-    SetKeyAt(i, KeyAt(i + 1));
-    SetValueAt(i, ValueAt(i + 1));
-  }
+  memmove(PairAt(index), PairAt(index + 1), (GetSize() - index - 1) * PairSize());
   SetSize(GetSize() - 1);
-  // SetKeyAt(GetSize(), nullptr);
-  // SetValueAt(GetSize(), RowId(0));
   return GetSize();
 }
 
@@ -212,15 +312,13 @@ int LeafPage::RemoveAndDeleteRecord(const GenericKey *key, const KeyManager &KM)
 /*
  * Remove all key & value pairs from this page to "recipient" page. Don't forget
  * to update the next_page id in the sibling page
+ * The recipient is the left sibling, it takes over the high key.
  */
 void LeafPage::MoveAllTo(LeafPage *recipient) {
-  recipient->CopyNFrom(pairs_off, GetSize());
+  recipient->SetHighKey(AsKey(HighFence()));
+  recipient->CopyNFrom(this, 0, GetSize());
   recipient->SetNextPageId(GetNextPageId());
-  recipient->SetSize(recipient->GetSize() + GetSize());
   SetSize(0);
-  // SetKeyAt(0, nullptr);
-  // SetValueAt(0, RowId(0));
-  // SetNextPageId(0);
 }
 
 /*****************************************************************************
@@ -228,48 +326,29 @@ void LeafPage::MoveAllTo(LeafPage *recipient) {
  *****************************************************************************/
 /*
  * Remove the first key & value pair from this page to "recipient" page.
- *
+ * The second key becomes the separator of the two pages.
  */
 void LeafPage::MoveFirstToEndOf(LeafPage *recipient){
-  recipient->CopyLastFrom(KeyAt(0), ValueAt(0));
-  for (int i = 0; i < GetSize() - 1; i++) {
-    SetKeyAt(i, KeyAt(i + 1));
-    SetValueAt(i, ValueAt(i + 1));
-  }
+  std::string separator(key_length_, '\0');
+  CopyKeyAt(1, separator.data());
+  recipient->SetHighKey(AsKey(separator.data()));
+  recipient->CopyNFrom(this, 0, 1);
+  memmove(PairAt(0), PairAt(1), (GetSize() - 1) * PairSize());
   SetSize(GetSize() - 1);
-  // SetKeyAt(GetSize(), nullptr);
-  // SetValueAt(GetSize(), RowId(0));
-}
-
-/*
- * Copy the item into the end of my item list. (Append item to my array)
- */
-void LeafPage::CopyLastFrom(GenericKey *key, const RowId value) {
-  SetKeyAt(GetSize(), key);
-  SetValueAt(GetSize(), value);
-  IncreaseSize(1);
+  SetKeyRange(AsKey(separator.data()), AsKey(HighFence()));
 }
 
 /*
  * Remove the last key & value pair from this page to "recipient" page.
+ * The key moved becomes the separator of the two pages.
  */
 void LeafPage::MoveLastToFrontOf(LeafPage *recipient) {
-  recipient->CopyFirstFrom(KeyAt(GetSize() - 1), ValueAt(GetSize() - 1));
-  // SetKeyAt(GetSize() - 1, nullptr);
-  // SetValueAt(GetSize() - 1, RowId(0));
+  std::string separator(key_length_, '\0');
+  CopyKeyAt(GetSize() - 1, separator.data());
+  recipient->SetKeyRange(AsKey(separator.data()), AsKey(recipient->HighFence()));
+  memmove(recipient->PairAt(1), recipient->PairAt(0), recipient->GetSize() * recipient->PairSize());
+  recipient->CopyPairFrom(this, GetSize() - 1, 0);
+  recipient->IncreaseSize(1);
   SetSize(GetSize() - 1);
+  SetHighKey(AsKey(separator.data()));
 }
-
-/*
- * Insert item at the front of my items. Move items accordingly.
- *
- */
-void LeafPage::CopyFirstFrom(GenericKey *key, const RowId value) {
-  for (int i = GetSize(); i > 0; i--) {
-    SetKeyAt(i, KeyAt(i - 1));
-    SetValueAt(i, ValueAt(i - 1));
-  }
-  SetKeyAt(0, key);
-  SetValueAt(0, value);
-  IncreaseSize(1);
-}
\ No newline at end of file
@@ -1,5 +1,10 @@
 #include "page/b_plus_tree_page.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MINISQL_HAVE_X86_SIMD
+#endif
+
 /*
  * Helper methods to get/set page type
  * Page type enum class is defined in b_plus_tree_page.h
@@ -107,4 +112,90 @@ void BPlusTreePage::SetPageId(page_id_t page_id) {
  */
 void BPlusTreePage::SetLSN(lsn_t lsn) {
   lsn_ = lsn;
-}
\ No newline at end of file
+}
+
+/*
+ * Node search for 8 byte keys
+ * Keys are compared as big-endian unsigned words. The SSE version flips the sign bit of both sides, since SSE only has
+ * a signed 64 bit compare.
+ */
+static inline uint64_t LoadWordKey(const char *key) {
+  uint64_t word;
+  memcpy(&word, key, sizeof(uint64_t));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  word = __builtin_bswap64(word);
+#endif
+  return word;
+}
+
+/** @return number of the count keys starting at pairs that are < key, or <= key if upper is true */
+using CountWordKeysFunc = int (*)(const char *pairs, size_t pair_size, int count, uint64_t key, bool upper);
+
+static int CountWordKeysScalar(const char *pairs, size_t pair_size, int count, uint64_t key, bool upper) {
+  int result = 0;
+  for (int i = 0; i < count; i++) {
+    uint64_t word = LoadWordKey(pairs + i * pair_size);
+    result += upper ? word <= key : word < key;
+  }
+  return result;
+}
+
+#ifdef MINISQL_HAVE_X86_SIMD
+__attribute__((target("sse4.2"))) static int CountWordKeysSSE42(const char *pairs, size_t pair_size, int count,
+                                                                 uint64_t key, bool upper) {
+  if (!upper && key == 0) {
+    return 0;
+  }
+  const __m128i sign = _mm_set1_epi64x(static_cast<int64_t>(0x8000000000000000ull));
+  const __m128i bswap = _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+  // word < key is the same as word <= key - 1, so both bounds are counted as the words that are not > target
+  const __m128i target = _mm_xor_si128(_mm_set1_epi64x(static_cast<int64_t>(upper ? key : key - 1)), sign);
+  int result = 0;
+  int i = 0;
+  for (; i + 2 <= count; i += 2) {
+    int64_t first, second;
+    memcpy(&first, pairs + i * pair_size, sizeof(int64_t));
+    memcpy(&second, pairs + (i + 1) * pair_size, sizeof(int64_t));
+    __m128i words = _mm_set_epi64x(second, first);
+    words = _mm_xor_si128(_mm_shuffle_epi8(words, bswap), sign);
+    // lanes with word > target are all ones
+    int greater = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(words, target)));
+    result += 2 - __builtin_popcount(greater);
+  }
+  return result + CountWordKeysScalar(pairs + i * pair_size, pair_size, count - i, key, upper);
+}
+#endif
+
+static CountWordKeysFunc SelectCountWordKeys() {
+#ifdef MINISQL_HAVE_X86_SIMD
+  // AVX2 is not used: keys are interleaved with values, and assembling four strided keys into a lane costs more than
+  // the wider compare saves
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse4.2")) {
+    return CountWordKeysSSE42;
+  }
+#endif
+  return CountWordKeysScalar;
+}
+
+int BPlusTreePage::SearchWordKeys(const char *pairs, size_t pair_size, int size, const GenericKey *key, bool upper) {
+  static const CountWordKeysFunc count_word_keys = SelectCountWordKeys();
+  // below this many keys, counting all of them beats the branch misses of the binary search
+  static constexpr int SCAN_WINDOW = 32;
+  uint64_t target = LoadWordKey(key->data);
+  int left = 0;
+  int right = size;
+  while (right - left > SCAN_WINDOW) {
+    int mid = (left + right) / 2;
+    uint64_t word = LoadWordKey(pairs + mid * pair_size);
+    if (word < target || (upper && word == target)) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  if (right <= left) {
+    return left;
+  }
+  return left + count_word_keys(pairs + left * pair_size, pair_size, right - left, target, upper);
+}
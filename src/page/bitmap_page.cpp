@@ -11,8 +11,14 @@ bool BitmapPage<PageSize>::AllocatePage(uint32_t &page_offset) {
   page_allocated_++;
   page_offset = next_free_page_;
   bytes[page_offset/8] |= 0x1 << (7-page_offset%8);
-  for(size_t offset = 0;offset < GetMaxSupportedSize();offset++){
-    if(IsPageFree(offset)) {next_free_page_ = offset;break;}
+  if(page_allocated_==GetMaxSupportedSize()) return true;
+  // next_free_page_ is the lowest free page, so only the pages after it need to be searched, full bytes are skipped
+  for(size_t i = 0;i < MAX_CHARS;i++){
+    uint32_t byte_index = (page_offset/8+i)%MAX_CHARS;
+    if(bytes[byte_index]==0xff) continue;
+    for(uint8_t bit_index = 0;bit_index < 8;bit_index++){
+      if(IsPageFreeLow(byte_index,bit_index)) {next_free_page_ = byte_index*8+bit_index;return true;}
+    }
   }
   return true;
 }
@@ -25,7 +31,7 @@ bool BitmapPage<PageSize>::DeAllocatePage(uint32_t page_offset) {
   if(IsPageFree(page_offset)) return false;
   page_allocated_--;
   bytes[page_offset/8] &= ~(0x1 << (7-page_offset%8));
-  next_free_page_ = page_offset;
+  if(page_allocated_==GetMaxSupportedSize()-1||page_offset<next_free_page_) next_free_page_ = page_offset;
   return true;
 }
 
@@ -1301,6 +1301,11 @@ case 55:
 YY_RULE_SETUP
 #line 290 "minisql.l"
 {
+  if (yytext[0] == '.') {
+    // separates a table name from a column name, a '.' in a number is matched by the rules above
+    MinisqlParserMovePos(yylineno, yytext);
+    return ('.');
+  }
   char str[128] = {0};
   sprintf(str, "Unrecognized token [%s] in input sql.", yytext);
   MinisqlParserSetError(str);
@@ -1308,10 +1313,10 @@ YY_RULE_SETUP
 	YY_BREAK
 case 56:
 YY_RULE_SETUP
-#line 296 "minisql.l"
+#line 301 "minisql.l"
 ECHO;
 	YY_BREAK
-#line 1314 "../../parser/minisql_lex.c"
+#line 1319 "../../parser/minisql_lex.c"
 case YY_STATE_EOF(INITIAL):
 	yyterminate();
 
@@ -2320,7 +2325,7 @@ void yyfree (void * ptr )
 
 #define YYTABLES_NAME "yytables"
 
-#line 296 "minisql.l"
+#line 301 "minisql.l"
 
 
 int yywrap() {
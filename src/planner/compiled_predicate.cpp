@@ -0,0 +1,221 @@
+#include "planner/expressions/compiled_predicate.h"
+
+#include <algorithm>
+
+#include "planner/expressions/column_value_expression.h"
+#include "planner/expressions/comparison_expression.h"
+#include "planner/expressions/constant_value_expression.h"
+#include "planner/expressions/logic_expression.h"
+
+CompiledPredicate::CompiledPredicate(AbstractExpressionRef predicate) : predicate_(std::move(predicate)) {
+  root_ = Compile(predicate_);
+}
+
+void CompiledPredicate::Select(const std::vector<Row> &rows, std::vector<uint32_t> &selection) const {
+  const Node &root = nodes_[root_];
+  size_t selected = 0;
+  for (auto idx : selection) {
+    if (Run(root, rows[idx]) == kTrue) {
+      selection[selected++] = idx;
+    }
+  }
+  selection.resize(selected);
+}
+
+uint32_t CompiledPredicate::AddNode(const Node &node) {
+  nodes_.push_back(node);
+  return nodes_.size() - 1;
+}
+
+uint32_t CompiledPredicate::AddConstant(CmpBool value) {
+  Node node{NodeType::Constant};
+  node.value_ = value;
+  return AddNode(node);
+}
+
+uint32_t CompiledPredicate::Compile(const AbstractExpressionRef &expr) {
+  if (expr->GetType() == ExpressionType::LogicExpression) {
+    bool is_and = std::dynamic_pointer_cast<LogicExpression>(expr)->logic_type_ == LogicType::And;
+    uint32_t children[2] = {Compile(expr->GetChildAt(0)), Compile(expr->GetChildAt(1))};
+    // false decides an AND and true decides an OR, while the other value leaves the result to the other side
+    CmpBool decisive = is_and ? kFalse : kTrue;
+    for (uint32_t side = 0; side < 2; side++) {
+      const Node &child = nodes_[children[side]];
+      if (child.type_ == NodeType::Constant && child.value_ == decisive) {
+        return AddConstant(decisive);
+      }
+    }
+    for (uint32_t side = 0; side < 2; side++) {
+      const Node &child = nodes_[children[side]];
+      if (child.type_ == NodeType::Constant && child.value_ != kNull) {
+        return children[1 - side];
+      }
+    }
+    Node node{is_and ? NodeType::And : NodeType::Or};
+    node.children_[0] = children[0];
+    node.children_[1] = children[1];
+    return AddNode(node);
+  }
+  Node node{NodeType::Expression};
+  node.expression_ = expr.get();
+  if (expr->GetType() != ExpressionType::ComparisonExpression) {
+    return AddNode(node);
+  }
+  bool is_constant[2];
+  for (uint32_t side = 0; side < 2; side++) {
+    const auto &child = expr->GetChildAt(side);
+    is_constant[side] = child->GetType() == ExpressionType::ConstantExpression;
+    if (is_constant[side]) {
+      node.constants_[side] = &std::dynamic_pointer_cast<ConstantValueExpression>(child)->val_;
+    } else if (child->GetType() == ExpressionType::ColumnExpression) {
+      node.columns_[side] = std::dynamic_pointer_cast<ColumnValueExpression>(child)->GetColIdx();
+    } else {
+      return AddNode(node);
+    }
+  }
+  std::string comp_type = std::dynamic_pointer_cast<ComparisonExpression>(expr)->GetComparisonType();
+  if (comp_type == "is" || comp_type == "not") {
+    if (is_constant[0]) {
+      return AddConstant(GetCmpBool(node.constants_[0]->IsNull() == (comp_type == "is")));
+    }
+    node.type_ = comp_type == "is" ? NodeType::IsNull : NodeType::IsNotNull;
+    return AddNode(node);
+  }
+  if (is_constant[0] && is_constant[1]) {
+    Field value = expr->Evaluate(nullptr);
+    return AddConstant(value.IsNull() ? kNull : static_cast<CmpBool>(value.value_.integer_));
+  }
+  // nothing compares to NULL
+  for (uint32_t side = 0; side < 2; side++) {
+    if (is_constant[side] && node.constants_[side]->IsNull()) {
+      return AddConstant(kNull);
+    }
+  }
+  TypeId type = expr->GetChildAt(0)->GetReturnType();
+  if (type == expr->GetChildAt(1)->GetReturnType()) {
+    node.compare_ = GetCompareFunction(comp_type, type);
+  }
+  if (node.compare_ != nullptr) {
+    node.type_ = NodeType::Compare;
+  }
+  return AddNode(node);
+}
+
+CmpBool CompiledPredicate::Run(const Node &node, const Row &row) const {
+  switch (node.type_) {
+    case NodeType::Constant:
+      return node.value_;
+    case NodeType::And: {
+      CmpBool lhs = Run(nodes_[node.children_[0]], row);
+      if (lhs == kFalse) {
+        return kFalse;
+      }
+      CmpBool rhs = Run(nodes_[node.children_[1]], row);
+      if (rhs == kFalse) {
+        return kFalse;
+      }
+      return lhs == kTrue && rhs == kTrue ? kTrue : kNull;
+    }
+    case NodeType::Or: {
+      CmpBool lhs = Run(nodes_[node.children_[0]], row);
+      if (lhs == kTrue) {
+        return kTrue;
+      }
+      CmpBool rhs = Run(nodes_[node.children_[1]], row);
+      if (rhs == kTrue) {
+        return kTrue;
+      }
+      return lhs == kFalse && rhs == kFalse ? kFalse : kNull;
+    }
+    case NodeType::Compare:
+      return node.compare_(Operand(node, 0, row), Operand(node, 1, row));
+    case NodeType::IsNull:
+      return GetCmpBool(Operand(node, 0, row).IsNull());
+    case NodeType::IsNotNull:
+      return GetCmpBool(!Operand(node, 0, row).IsNull());
+    case NodeType::Expression: {
+      Field value = node.expression_->Evaluate(&row);
+      return value.IsNull() ? kNull : static_cast<CmpBool>(value.value_.integer_);
+    }
+    default:
+      throw std::logic_error("Unsupported predicate node.");
+  }
+}
+
+CompiledPredicate::CompareFunction CompiledPredicate::GetCompareFunction(const std::string &comp_type, TypeId type) {
+  if (comp_type == "=")
+    return GetCompareFunction<CompareOp::Equal>(type);
+  else if (comp_type == "<>")
+    return GetCompareFunction<CompareOp::NotEqual>(type);
+  else if (comp_type == "<")
+    return GetCompareFunction<CompareOp::Less>(type);
+  else if (comp_type == "<=")
+    return GetCompareFunction<CompareOp::LessEqual>(type);
+  else if (comp_type == ">")
+    return GetCompareFunction<CompareOp::Greater>(type);
+  else if (comp_type == ">=")
+    return GetCompareFunction<CompareOp::GreaterEqual>(type);
+  else
+    return nullptr;
+}
+
+template <CompiledPredicate::CompareOp op>
+CompiledPredicate::CompareFunction CompiledPredicate::GetCompareFunction(TypeId type) {
+  switch (type) {
+    case TypeId::kTypeInt:
+      return &CompareInts<op>;
+    case TypeId::kTypeFloat:
+      return &CompareFloats<op>;
+    case TypeId::kTypeChar:
+      return &CompareChars<op>;
+    default:
+      return nullptr;
+  }
+}
+
+template <CompiledPredicate::CompareOp op, typename T>
+CmpBool CompiledPredicate::Decide(T lhs, T rhs) {
+  switch (op) {
+    case CompareOp::Equal:
+      return GetCmpBool(lhs == rhs);
+    case CompareOp::NotEqual:
+      return GetCmpBool(lhs != rhs);
+    case CompareOp::Less:
+      return GetCmpBool(lhs < rhs);
+    case CompareOp::LessEqual:
+      return GetCmpBool(lhs <= rhs);
+    case CompareOp::Greater:
+      return GetCmpBool(lhs > rhs);
+    default:
+      return GetCmpBool(lhs >= rhs);
+  }
+}
+
+template <CompiledPredicate::CompareOp op>
+CmpBool CompiledPredicate::CompareInts(const Field &lhs, const Field &rhs) {
+  if (lhs.is_null_ || rhs.is_null_) {
+    return kNull;
+  }
+  return Decide<op>(lhs.value_.integer_, rhs.value_.integer_);
+}
+
+template <CompiledPredicate::CompareOp op>
+CmpBool CompiledPredicate::CompareFloats(const Field &lhs, const Field &rhs) {
+  if (lhs.is_null_ || rhs.is_null_) {
+    return kNull;
+  }
+  return Decide<op>(lhs.value_.float_, rhs.value_.float_);
+}
+
+/** Same order as TypeChar: bytes first, then the shorter string first */
+template <CompiledPredicate::CompareOp op>
+CmpBool CompiledPredicate::CompareChars(const Field &lhs, const Field &rhs) {
+  if (lhs.is_null_ || rhs.is_null_) {
+    return kNull;
+  }
+  int result = memcmp(lhs.value_.chars_, rhs.value_.chars_, std::min(lhs.len_, rhs.len_));
+  if (result == 0) {
+    result = static_cast<int>(lhs.len_) - static_cast<int>(rhs.len_);
+  }
+  return Decide<op>(result, 0);
+}
@@ -3,6 +3,9 @@
 //
 #include "planner/planner.h"
 
+#include <algorithm>
+#include <thread>
+
 void Planner::PlanQuery(pSyntaxNode ast) {
   switch (ast->type_) {
     case kNodeSelect: {
@@ -34,25 +37,272 @@ void Planner::PlanQuery(pSyntaxNode ast) {
   }
 }
 AbstractPlanNodeRef Planner::PlanSelect(std::shared_ptr<SelectStatement> statement) {
-  auto out_schema = MakeOutputSchema(statement->column_list_);
+  if (statement->table_names_.size() > 1) {
+    return PlanJoin(statement);
+  }
+  return PlanScan(statement->table_name_, MakeOutputSchema(statement->column_list_), statement->where_,
+                  statement->column_in_condition_, statement->has_or);
+}
+
+AbstractPlanNodeRef Planner::PlanScan(const std::string &table_name, const Schema *out_schema,
+                                      const AbstractExpressionRef &where,
+                                      const std::vector<uint32_t> &column_in_condition, bool has_or) {
   vector<IndexInfo *> indexes;
   vector<IndexInfo *> available_index;
-  context_->GetCatalog()->GetTableIndexes(statement->table_name_, indexes);
+  context_->GetCatalog()->GetTableIndexes(table_name, indexes);
+  // an index is available if the condition has its leading key column, the ones with the longest prefix of key
+  // columns in the condition come first
+  vector<pair<size_t, IndexInfo *>> prefixes;
   for (auto index : indexes) {
-    if (index->GetIndexKeySchema()->GetColumns().size() == 1) {
-      auto col_id = index->GetIndexKeySchema()->GetColumn(0)->GetTableInd();
-      if (std::find(statement->column_in_condition_.begin(), statement->column_in_condition_.end(), col_id) !=
-          statement->column_in_condition_.end()) {
-        available_index.push_back(index);
+    size_t prefix = 0;
+    for (auto column : index->GetIndexKeySchema()->GetColumns()) {
+      if (std::find(column_in_condition.begin(), column_in_condition.end(),
+                    column->GetTableInd()) == column_in_condition.end()) {
+        break;
       }
+      prefix++;
+    }
+    if (prefix > 0) {
+      prefixes.emplace_back(prefix, index);
+    }
+  }
+  std::stable_sort(prefixes.begin(), prefixes.end(),
+                   [](const auto &lhs, const auto &rhs) { return lhs.first > rhs.first; });
+  for (auto &prefix : prefixes) {
+    available_index.push_back(prefix.second);
+  }
+  if (available_index.empty() || has_or) {
+    size_t parallelism = PARALLEL_SCAN_WORKERS > 0 ? PARALLEL_SCAN_WORKERS : std::thread::hardware_concurrency();
+    return make_shared<SeqScanPlanNode>(out_schema, table_name, where, std::max<size_t>(parallelism, 1));
+  }
+  // an index covers the query if its key holds every column of the output and of the condition, the table is then
+  // never read. Only the indexes with the longest prefix are considered, one with a shorter prefix may read many
+  // more entries than the rows it saves fetching.
+  vector<IndexInfo *> covering_index;
+  for (auto &prefix : prefixes) {
+    if (prefix.first != prefixes.front().first) {
+      break;
     }
+    const auto &key_columns = prefix.second->GetIndexKeySchema()->GetColumns();
+    auto in_key = [&key_columns](uint32_t table_ind) {
+      return std::any_of(key_columns.begin(), key_columns.end(),
+                         [table_ind](const Column *column) { return column->GetTableInd() == table_ind; });
+    };
+    if (std::all_of(column_in_condition.begin(), column_in_condition.end(), in_key) &&
+        std::all_of(out_schema->GetColumns().begin(), out_schema->GetColumns().end(),
+                    [&in_key](const Column *column) { return in_key(column->GetTableInd()); })) {
+      covering_index.push_back(prefix.second);
+    }
+  }
+  if (!covering_index.empty()) {
+    return make_shared<IndexOnlyScanPlanNode>(out_schema, table_name, covering_index,
+                                              available_index.size() != column_in_condition.size(),
+                                              where);
   }
-  if (available_index.empty() || statement->has_or) {
-    return make_shared<SeqScanPlanNode>(out_schema, statement->table_name_, statement->where_);
+  return make_shared<IndexScanPlanNode>(out_schema, table_name, available_index,
+                                        available_index.size() != column_in_condition.size(),
+                                        where);
+}
+
+namespace {
+
+/** Collect the operands of the ANDs at the top of a predicate */
+void SplitConjunction(const AbstractExpressionRef &predicate, std::vector<AbstractExpressionRef> &conditions) {
+  if (predicate->GetType() == ExpressionType::LogicExpression &&
+      dynamic_pointer_cast<LogicExpression>(predicate)->logic_type_ == LogicType::And) {
+    for (const auto &child : predicate->GetChildren()) {
+      SplitConjunction(child, conditions);
+    }
+    return;
+  }
+  conditions.push_back(predicate);
+}
+
+/** Collect the indexes of the columns an expression reads, once each */
+void CollectColumns(const AbstractExpressionRef &expr, std::vector<uint32_t> &columns) {
+  if (expr->GetType() == ExpressionType::ColumnExpression) {
+    uint32_t index = dynamic_pointer_cast<ColumnValueExpression>(expr)->GetColIdx();
+    if (std::find(columns.begin(), columns.end(), index) == columns.end()) {
+      columns.push_back(index);
+    }
+  }
+  for (const auto &child : expr->GetChildren()) {
+    CollectColumns(child, columns);
+  }
+}
+
+/** @return true if the expression has an OR */
+bool HasOr(const AbstractExpressionRef &expr) {
+  if (expr->GetType() == ExpressionType::LogicExpression &&
+      dynamic_pointer_cast<LogicExpression>(expr)->logic_type_ == LogicType::Or) {
+    return true;
+  }
+  return std::any_of(expr->GetChildren().begin(), expr->GetChildren().end(), HasOr);
+}
+
+/** @return a copy of the expression reading column i - offset wherever it read column i */
+AbstractExpressionRef ShiftColumns(const AbstractExpressionRef &expr, uint32_t offset) {
+  switch (expr->GetType()) {
+    case ExpressionType::ColumnExpression: {
+      auto column = dynamic_pointer_cast<ColumnValueExpression>(expr);
+      return std::make_shared<ColumnValueExpression>(0, column->GetColIdx() - offset, column->GetReturnType());
+    }
+    case ExpressionType::ComparisonExpression:
+      return std::make_shared<ComparisonExpression>(ShiftColumns(expr->GetChildAt(0), offset),
+                                                    ShiftColumns(expr->GetChildAt(1), offset),
+                                                    dynamic_pointer_cast<ComparisonExpression>(expr)->GetComparisonType());
+    case ExpressionType::LogicExpression:
+      return std::make_shared<LogicExpression>(ShiftColumns(expr->GetChildAt(0), offset),
+                                               ShiftColumns(expr->GetChildAt(1), offset),
+                                               dynamic_pointer_cast<LogicExpression>(expr)->logic_type_);
+    default:
+      return expr;
+  }
+}
+
+/** @return the conjunction of two predicates, either of which may be null */
+AbstractExpressionRef MakeAnd(const AbstractExpressionRef &lhs, const AbstractExpressionRef &rhs) {
+  if (lhs == nullptr) {
+    return rhs;
+  }
+  return std::make_shared<LogicExpression>(lhs, rhs, LogicType::And);
+}
+
+}  // namespace
+
+/*
+ * The tables are joined left-deep in FROM order, and the statement bound the columns to their index in the row made
+ * of all the tables one after the other, which is also the row of each join. The condition is split on its ANDs:
+ * - a comparison on a single table filters the scan of that table, which may then use an index;
+ * - an equality between a column of the table joined and a column of the tables before it is a key of the join;
+ * - anything else is checked on the rows of the first join that has all of its tables.
+ * Without any key, a join matches every pair of rows. A join is a hash join, or a nested index join when an index of
+ * the table joined can be looked up with the keys.
+ */
+AbstractPlanNodeRef Planner::PlanJoin(std::shared_ptr<SelectStatement> statement) {
+  std::vector<TableInfo *> tables;
+  std::vector<uint32_t> offsets{0};  // offsets[i] is the index of the first column of table i in the joined row
+  for (const auto &table_name : statement->table_names_) {
+    TableInfo *info = nullptr;
+    context_->GetCatalog()->GetTable(table_name, info);
+    tables.push_back(info);
+    offsets.push_back(offsets.back() + info->GetSchema()->GetColumnCount());
+  }
+  auto table_of = [&offsets](uint32_t column) {
+    return static_cast<size_t>(std::upper_bound(offsets.begin(), offsets.end(), column) - offsets.begin() - 1);
+  };
+  std::vector<AbstractExpressionRef> conditions;
+  if (statement->where_ != nullptr) {
+    SplitConjunction(statement->where_, conditions);
+  }
+  std::vector<AbstractExpressionRef> filters(tables.size());  // on the columns of the table alone
+  std::vector<std::vector<uint32_t>> filter_columns(tables.size());
+  std::vector<AbstractExpressionRef> table_conditions(tables.size());  // the same on the columns of the joined row
+  std::vector<std::vector<AbstractExpressionRef>> join_conditions(tables.size());
+  for (const auto &condition : conditions) {
+    std::vector<uint32_t> columns;
+    CollectColumns(condition, columns);
+    size_t first = 0, last = 0;
+    if (!columns.empty()) {
+      first = table_of(*std::min_element(columns.begin(), columns.end()));
+      last = table_of(*std::max_element(columns.begin(), columns.end()));
+    }
+    if (first != last) {
+      join_conditions[last].push_back(condition);
+      continue;
+    }
+    filters[first] = MakeAnd(filters[first], ShiftColumns(condition, offsets[first]));
+    table_conditions[first] = MakeAnd(table_conditions[first], condition);
+    for (auto column : columns) {
+      filter_columns[first].push_back(column - offsets[first]);
+    }
+  }
+  auto plan_scan = [&](size_t i) {
+    return PlanScan(tables[i]->GetTableName(), tables[i]->GetSchema(), filters[i], filter_columns[i],
+                    filters[i] != nullptr && HasOr(filters[i]));
+  };
+  AbstractPlanNodeRef plan = plan_scan(0);
+  for (size_t i = 1; i < tables.size(); i++) {
+    std::vector<AbstractExpressionRef> key_conditions, left_keys, right_keys;
+    AbstractExpressionRef predicate = nullptr;
+    for (const auto &condition : join_conditions[i]) {
+      if (condition->GetType() == ExpressionType::ComparisonExpression &&
+          dynamic_pointer_cast<ComparisonExpression>(condition)->GetComparisonType() == "=" &&
+          condition->GetChildAt(0)->GetType() == ExpressionType::ColumnExpression &&
+          condition->GetChildAt(1)->GetType() == ExpressionType::ColumnExpression) {
+        auto lhs = dynamic_pointer_cast<ColumnValueExpression>(condition->GetChildAt(0));
+        auto rhs = dynamic_pointer_cast<ColumnValueExpression>(condition->GetChildAt(1));
+        if (table_of(lhs->GetColIdx()) == i) {
+          std::swap(lhs, rhs);
+        }
+        if (table_of(lhs->GetColIdx()) < i && table_of(rhs->GetColIdx()) == i) {
+          key_conditions.push_back(condition);
+          left_keys.push_back(lhs);
+          right_keys.push_back(ShiftColumns(rhs, offsets[i]));
+          continue;
+        }
+      }
+      predicate = MakeAnd(predicate, condition);
+    }
+    const Schema *out_schema;
+    if (i + 1 == tables.size()) {
+      out_schema = MakeOutputSchema(statement->column_list_);
+    } else {
+      std::vector<Column *> columns;
+      for (size_t j = 0; j <= i; j++) {
+        for (auto column : tables[j]->GetSchema()->GetColumns()) {
+          columns.push_back(new Column(column));
+          columns.back()->SetTableInd(columns.size() - 1);
+        }
+      }
+      out_schema = new Schema(columns);
+    }
+    // Without statistics, an outer side with a condition on each of its tables is taken to be small. Looking its rows
+    // up in an index of table i then reads much less than the hash join, which reads table i in full. The index with
+    // the most leading key columns among the join keys is used.
+    IndexInfo *lookup_index = nullptr;
+    std::vector<size_t> lookup_keys;  // the join keys matching the leading key columns of lookup_index
+    if (std::all_of(filters.begin(), filters.begin() + i, [](const auto &filter) { return filter != nullptr; })) {
+      std::vector<IndexInfo *> indexes;
+      context_->GetCatalog()->GetTableIndexes(tables[i]->GetTableName(), indexes);
+      for (auto index : indexes) {
+        std::vector<size_t> keys;
+        for (auto column : index->GetIndexKeySchema()->GetColumns()) {
+          auto key = std::find_if(right_keys.begin(), right_keys.end(), [column](const AbstractExpressionRef &right) {
+            return dynamic_pointer_cast<ColumnValueExpression>(right)->GetColIdx() == column->GetTableInd();
+          });
+          if (key == right_keys.end()) {
+            break;
+          }
+          keys.push_back(key - right_keys.begin());
+        }
+        if (keys.size() > lookup_keys.size()) {
+          lookup_index = index;
+          lookup_keys = std::move(keys);
+        }
+      }
+    }
+    if (lookup_index == nullptr) {
+      plan = std::make_shared<HashJoinPlanNode>(out_schema, plan, plan_scan(i), left_keys, right_keys, predicate);
+      continue;
+    }
+    // the other join keys and the condition on table i are checked on the joined rows
+    std::vector<AbstractExpressionRef> lookup_values;
+    for (auto key : lookup_keys) {
+      lookup_values.push_back(left_keys[key]);
+    }
+    for (size_t key = 0; key < key_conditions.size(); key++) {
+      if (std::find(lookup_keys.begin(), lookup_keys.end(), key) == lookup_keys.end()) {
+        predicate = MakeAnd(predicate, key_conditions[key]);
+      }
+    }
+    if (table_conditions[i] != nullptr) {
+      predicate = MakeAnd(predicate, table_conditions[i]);
+    }
+    plan = std::make_shared<NestedIndexJoinPlanNode>(out_schema, plan, tables[i]->GetTableName(), lookup_index,
+                                                     lookup_values, predicate);
   }
-  return make_shared<IndexScanPlanNode>(out_schema, statement->table_name_, available_index,
-                                        available_index.size() != statement->column_in_condition_.size(),
-                                        statement->where_);
+  return plan;
 }
 
 AbstractPlanNodeRef Planner::PlanInsert(std::shared_ptr<InsertStatement> statement) {
@@ -1,38 +1,60 @@
 #include "storage/disk_manager.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
+#include <cerrno>
+#include <cstdlib>
 #include <filesystem>
 #include <stdexcept>
 
 #include "glog/logging.h"
 #include "page/bitmap_page.h"
 
-DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
+DiskManager::DiskManager(const std::string &db_file, bool direct_io, bool read_only)
+    : file_name_(db_file), read_only_(read_only) {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    std::filesystem::path p = db_file;
-    if (p.has_parent_path()) std::filesystem::create_directories(p.parent_path());
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out);
-    db_io_.close();
-    // reopen with original mode
-    db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-    if (!db_io_.is_open()) {
-      throw std::exception();
+  int flags = read_only ? O_RDONLY : O_RDWR | O_CREAT;
+  // directory does not exist
+  std::filesystem::path p = db_file;
+  if (!read_only && p.has_parent_path()) std::filesystem::create_directories(p.parent_path());
+  if (direct_io) {
+    db_fd_ = open(db_file.c_str(), flags | O_DIRECT, 0644);
+    if (db_fd_ < 0) {
+      LOG(WARNING) << "O_DIRECT is not supported for " << db_file << ", falling back to buffered I/O";
+    } else {
+      direct_io_ = true;
     }
   }
+  if (db_fd_ < 0) {
+    db_fd_ = open(db_file.c_str(), flags, 0644);
+  }
+  if (db_fd_ < 0) {
+    throw std::exception();
+  }
+  off_t file_size = GetFileSize(file_name_);
+  file_size_ = file_size < 0 ? 0 : static_cast<size_t>(file_size);
+  io_ring_ = new PageIORing();
   ReadPhysicalPage(META_PAGE_ID, meta_data_);
 }
 
 void DiskManager::Close() {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
-  WritePhysicalPage(META_PAGE_ID, meta_data_);
   if (!closed) {
-    db_io_.close();
+    // waits for the batches in flight
+    delete io_ring_;
+    io_ring_ = nullptr;
+    if (!read_only_) {
+      FlushBitmaps();
+      WritePhysicalPage(META_PAGE_ID, meta_data_);
+    }
+    for (auto bitmap : bitmaps_) {
+      delete bitmap;
+    }
+    bitmaps_.clear();
+    close(db_fd_);
     closed = true;
   }
 }
@@ -42,43 +64,61 @@ void DiskManager::ReadPage(page_id_t logical_page_id, char *page_data) {
   ReadPhysicalPage(MapPageId(logical_page_id), page_data);
 }
 
-void DiskManager::WritePage(page_id_t logical_page_id, const char *page_data) {
+bool DiskManager::WritePage(page_id_t logical_page_id, const char *page_data) {
   ASSERT(logical_page_id >= 0, "Invalid page id.");
   if(logical_page_id == CATALOG_META_PAGE_ID){
     LOG(INFO)<< "Writing to catalog meta page, this should be done carefully.";
   }
-  WritePhysicalPage(MapPageId(logical_page_id), page_data);
+  return WritePhysicalPage(MapPageId(logical_page_id), page_data);
+}
+
+void DiskManager::ReadPagesAsync(const std::vector<PageIO> &pages, const PageIOCallback &callback) {
+  SubmitPages(pages, false, callback);
+}
+
+void DiskManager::WritePagesAsync(const std::vector<PageIO> &pages, const PageIOCallback &callback) {
+  SubmitPages(pages, true, callback);
+}
+
+void DiskManager::ReadPages(const std::vector<PageIO> &pages) { SubmitPagesAndWait(pages, false); }
+
+std::vector<page_id_t> DiskManager::WritePages(const std::vector<PageIO> &pages) {
+  return SubmitPagesAndWait(pages, true);
+}
+
+bool DiskManager::MapPage(page_id_t logical_page_id, char *address) {
+  ASSERT(logical_page_id >= 0, "Invalid page id.");
+  size_t offset = static_cast<size_t>(MapPageId(logical_page_id)) * PAGE_SIZE;
+  // touching a mapping past the end of the file raises SIGBUS
+  if (offset + PAGE_SIZE > file_size_.load()) {
+    return false;
+  }
+  return mmap(address, PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, db_fd_, offset) != MAP_FAILED;
 }
 
 /**
  * TODO: Student Implement
  */
 page_id_t DiskManager::AllocatePage() {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
   DiskFileMetaPage* meta_page = reinterpret_cast<DiskFileMetaPage*> (meta_data_);
   ASSERT(meta_page->GetAllocatedPages()<=MAX_VALID_PAGE_ID,"DiskManager::AllocatePage out of size") ;
+  while(free_extent_hint_<meta_page->num_extents_&&meta_page->extent_used_page_[free_extent_hint_]>=BITMAP_SIZE){
+    free_extent_hint_++;
+  }
+  uint32_t extent_offset = free_extent_hint_;
   bool new_extent = false;
-  if(meta_page->GetAllocatedPages()>=meta_page->num_extents_*BITMAP_SIZE){
+  if(extent_offset==meta_page->num_extents_){
     meta_page->num_extents_++;
-    meta_page->extent_used_page_[meta_page->num_extents_-1] = 0;
+    meta_page->extent_used_page_[extent_offset] = 0;
     new_extent = true;
   }
-  page_id_t physical_bitmap_id;
-  uint32_t extent_offset;
-  for(int i=0;i<meta_page->num_extents_;i++){
-    if(meta_page->extent_used_page_[i] < BITMAP_SIZE){
-      extent_offset = i;
-      break;
-    }
-  }
-  physical_bitmap_id = extent_offset*(BITMAP_SIZE+1)+1;
-  meta_page->extent_used_page_[extent_offset]++;
-  meta_page->num_allocated_pages_++;
-  BitmapPage<PAGE_SIZE>* bitmap_page=new BitmapPage<PAGE_SIZE>();
-  if(!new_extent) ReadPhysicalPage(physical_bitmap_id,reinterpret_cast<char*>(bitmap_page));
+  BitmapPage<PAGE_SIZE>* bitmap_page = GetBitmap(extent_offset,new_extent);
   uint32_t page_offset;
   bitmap_page->AllocatePage(page_offset);
-  WritePhysicalPage(physical_bitmap_id,reinterpret_cast<char*>(bitmap_page));
-  delete bitmap_page;
+  bitmap_dirty_[extent_offset] = true;
+  meta_page->extent_used_page_[extent_offset]++;
+  meta_page->num_allocated_pages_++;
   return extent_offset*BITMAP_SIZE+page_offset;
 }
 
@@ -86,31 +126,52 @@ page_id_t DiskManager::AllocatePage() {
  * TODO: Student Implement
  */
 void DiskManager::DeAllocatePage(page_id_t logical_page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
   DiskFileMetaPage* meta_page = reinterpret_cast<DiskFileMetaPage*> (meta_data_);
-  BitmapPage<PAGE_SIZE>* bitmap_page=new BitmapPage<PAGE_SIZE>();
   uint32_t extent_offset = logical_page_id/BITMAP_SIZE;
   uint32_t page_offset = logical_page_id%BITMAP_SIZE;
-  ReadPhysicalPage(extent_offset*(BITMAP_SIZE+1)+1,reinterpret_cast<char*>(bitmap_page));
-  bitmap_page->DeAllocatePage(page_offset);
-  WritePhysicalPage(extent_offset*(BITMAP_SIZE+1)+1,reinterpret_cast<char*>(bitmap_page));
+  if(extent_offset>=meta_page->num_extents_) return;
+  if(!GetBitmap(extent_offset)->DeAllocatePage(page_offset)) return;
+  bitmap_dirty_[extent_offset] = true;
   meta_page->extent_used_page_[extent_offset]--;
   meta_page->num_allocated_pages_--;
-  delete bitmap_page;
+  if(extent_offset<free_extent_hint_) free_extent_hint_ = extent_offset;
 }
 
 /**
  * TODO: Student Implement
  */
 bool DiskManager::IsPageFree(page_id_t logical_page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
   DiskFileMetaPage* meta_page = reinterpret_cast<DiskFileMetaPage*> (meta_data_);
-  // if(logical_page_id/BITMAP_SIZE<=meta_page->GetExtentNums()||meta_page->extent_used_page_[logical_page_id/BITMAP_SIZE] == 0) {
-  //   return true; // no extent allocated
-  // }
-  BitmapPage<PAGE_SIZE>* bitmap_page=new BitmapPage<PAGE_SIZE>();
-  ReadPhysicalPage((logical_page_id / BITMAP_SIZE) * (BITMAP_SIZE + 1) +1,reinterpret_cast<char*>(bitmap_page));
-  bool result = bitmap_page->IsPageFree(logical_page_id % BITMAP_SIZE);
-  delete bitmap_page;
-  return result;
+  uint32_t extent_offset = logical_page_id/BITMAP_SIZE;
+  // no extent allocated
+  if(extent_offset>=meta_page->num_extents_) return true;
+  return GetBitmap(extent_offset)->IsPageFree(logical_page_id%BITMAP_SIZE);
+}
+
+BitmapPage<PAGE_SIZE> *DiskManager::GetBitmap(uint32_t extent_id, bool new_extent) {
+  if (extent_id >= bitmaps_.size()) {
+    bitmaps_.resize(extent_id + 1, nullptr);
+    bitmap_dirty_.resize(extent_id + 1, false);
+  }
+  if (bitmaps_[extent_id] == nullptr) {
+    // value initialized, so a new extent starts with every page free
+    bitmaps_[extent_id] = new BitmapPage<PAGE_SIZE>();
+    if (!new_extent) {
+      ReadPhysicalPage(extent_id * (BITMAP_SIZE + 1) + 1, reinterpret_cast<char *>(bitmaps_[extent_id]));
+    }
+  }
+  return bitmaps_[extent_id];
+}
+
+void DiskManager::FlushBitmaps() {
+  for (size_t i = 0; i < bitmaps_.size(); i++) {
+    if (bitmaps_[i] != nullptr && bitmap_dirty_[i]) {
+      WritePhysicalPage(i * (BITMAP_SIZE + 1) + 1, reinterpret_cast<const char *>(bitmaps_[i]));
+      bitmap_dirty_[i] = false;
+    }
+  }
 }
 
 /**
@@ -121,45 +182,167 @@ page_id_t DiskManager::MapPageId(page_id_t logical_page_id) {
   return physical_page_id;
 }
 
-int DiskManager::GetFileSize(const std::string &file_name) {
+off_t DiskManager::GetFileSize(const std::string &file_name) {
   struct stat stat_buf;
   int rc = stat(file_name.c_str(), &stat_buf);
   return rc == 0 ? stat_buf.st_size : -1;
 }
 
+void DiskManager::ExtendFileSize(size_t end_offset) {
+  size_t file_size = file_size_.load();
+  while (file_size < end_offset && !file_size_.compare_exchange_weak(file_size, end_offset)) {
+  }
+}
+
+/**
+ * O_DIRECT needs page aligned buffers. Frames of the buffer pool are not aligned, so they go through a per thread
+ * bounce buffer.
+ */
+static char *DirectIOBuffer() {
+  struct AlignedBuffer {
+    AlignedBuffer() : data_(static_cast<char *>(std::aligned_alloc(PAGE_SIZE, PAGE_SIZE))) {}
+    ~AlignedBuffer() { std::free(data_); }
+    char *data_;
+  };
+  thread_local AlignedBuffer buffer;
+  return buffer.data_;
+}
+
+/**
+ * Reads past the end of the file complete immediately with a zeroed page. Under O_DIRECT every unaligned page gets its
+ * own aligned buffer, since the per thread bounce buffer cannot be shared by operations in flight.
+ */
+void DiskManager::SubmitPages(const std::vector<PageIO> &pages, bool write, const PageIOCallback &callback) {
+  if (!io_ring_->IsAvailable() || (write && read_only_)) {
+    for (const auto &page : pages) {
+      bool success = true;
+      if (write) {
+        success = WritePage(page.page_id_, page.data_);
+      } else {
+        ReadPage(page.page_id_, page.data_);
+      }
+      callback(page.page_id_, success);
+    }
+    return;
+  }
+  std::vector<PageIORing::Operation> operations;
+  operations.reserve(pages.size());
+  for (const auto &page : pages) {
+    ASSERT(page.page_id_ >= 0, "Invalid page id.");
+    size_t offset = static_cast<size_t>(MapPageId(page.page_id_)) * PAGE_SIZE;
+    if (!write && offset >= file_size_.load()) {
+      memset(page.data_, 0, PAGE_SIZE);
+      callback(page.page_id_, true);
+      continue;
+    }
+    bool bounce = direct_io_ && reinterpret_cast<uintptr_t>(page.data_) % PAGE_SIZE != 0;
+    char *buffer = page.data_;
+    if (bounce) {
+      buffer = static_cast<char *>(std::aligned_alloc(PAGE_SIZE, PAGE_SIZE));
+      if (write) {
+        memcpy(buffer, page.data_, PAGE_SIZE);
+      }
+    }
+    auto done = [this, page, write, buffer, bounce, offset, callback](long result) {
+      bool success = write ? result == PAGE_SIZE : result >= 0;
+      if (!success) {
+        LOG(ERROR) << "I/O error while " << (write ? "writing" : "reading") << " page " << page.page_id_;
+      }
+      if (write && success) {
+        ExtendFileSize(offset + PAGE_SIZE);
+      }
+      if (!write) {
+        // if file ends before reading PAGE_SIZE
+        long read_count = result < 0 ? 0 : result;
+        if (read_count < PAGE_SIZE) {
+          memset(buffer + read_count, 0, PAGE_SIZE - read_count);
+        }
+        if (bounce) {
+          memcpy(page.data_, buffer, PAGE_SIZE);
+        }
+      }
+      if (bounce) {
+        std::free(buffer);
+      }
+      callback(page.page_id_, success);
+    };
+    operations.push_back({db_fd_, write, buffer, offset, done});
+  }
+  io_ring_->Submit(operations);
+}
+
+std::vector<page_id_t> DiskManager::SubmitPagesAndWait(const std::vector<PageIO> &pages, bool write) {
+  std::mutex latch;
+  std::condition_variable cv;
+  size_t remaining = pages.size();
+  std::vector<page_id_t> failed;
+  SubmitPages(pages, write, [&](page_id_t page_id, bool success) {
+    std::lock_guard<std::mutex> guard(latch);
+    if (!success) {
+      failed.push_back(page_id);
+    }
+    if (--remaining == 0) {
+      cv.notify_one();
+    }
+  });
+  std::unique_lock<std::mutex> lock(latch);
+  cv.wait(lock, [&] { return remaining == 0; });
+  return failed;
+}
+
 void DiskManager::ReadPhysicalPage(page_id_t physical_page_id, char *page_data) {
-  int offset = physical_page_id * PAGE_SIZE;
+  size_t offset = static_cast<size_t>(physical_page_id) * PAGE_SIZE;
   // check if read beyond file length
-  if (offset >= GetFileSize(file_name_)) {
+  if (offset >= file_size_.load()) {
 #ifdef ENABLE_BPM_DEBUG
     LOG(INFO) << "Read less than a page" << std::endl;
 #endif
     memset(page_data, 0, PAGE_SIZE);
-  } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, PAGE_SIZE);
-    // if file ends before reading PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < PAGE_SIZE) {
+    return;
+  }
+  bool bounce = direct_io_ && reinterpret_cast<uintptr_t>(page_data) % PAGE_SIZE != 0;
+  char *buffer = bounce ? DirectIOBuffer() : page_data;
+  ssize_t read_count;
+  do {
+    read_count = pread(db_fd_, buffer, PAGE_SIZE, offset);
+  } while (read_count < 0 && errno == EINTR);
+  if (read_count < 0) {
+    LOG(ERROR) << "I/O error while reading";
+    read_count = 0;
+  }
+  // if file ends before reading PAGE_SIZE
+  if (read_count < PAGE_SIZE) {
 #ifdef ENABLE_BPM_DEBUG
-      LOG(INFO) << "Read less than a page" << std::endl;
+    LOG(INFO) << "Read less than a page" << std::endl;
 #endif
-      memset(page_data + read_count, 0, PAGE_SIZE - read_count);
-    }
+    memset(buffer + read_count, 0, PAGE_SIZE - read_count);
+  }
+  if (bounce) {
+    memcpy(page_data, buffer, PAGE_SIZE);
   }
 }
 
-void DiskManager::WritePhysicalPage(page_id_t physical_page_id, const char *page_data) {
+bool DiskManager::WritePhysicalPage(page_id_t physical_page_id, const char *page_data) {
+  if (read_only_) {
+    LOG(ERROR) << "Cannot write to a read-only database file";
+    return false;
+  }
   size_t offset = static_cast<size_t>(physical_page_id) * PAGE_SIZE;
-  // set write cursor to offset
-  db_io_.seekp(offset);
-  db_io_.write(page_data, PAGE_SIZE);
+  const char *buffer = page_data;
+  if (direct_io_ && reinterpret_cast<uintptr_t>(page_data) % PAGE_SIZE != 0) {
+    char *bounce = DirectIOBuffer();
+    memcpy(bounce, page_data, PAGE_SIZE);
+    buffer = bounce;
+  }
+  ssize_t write_count;
+  do {
+    write_count = pwrite(db_fd_, buffer, PAGE_SIZE, offset);
+  } while (write_count < 0 && errno == EINTR);
   // check for I/O error
-  if (db_io_.bad()) {
+  if (write_count != PAGE_SIZE) {
     LOG(ERROR) << "I/O error while writing";
-    return;
+    return false;
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
+  ExtendFileSize(offset + PAGE_SIZE);
+  return true;
 }
\ No newline at end of file
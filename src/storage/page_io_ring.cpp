@@ -0,0 +1,216 @@
+#include "storage/page_io_ring.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "glog/logging.h"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define MINISQL_HAVE_IO_URING
+#endif
+
+#ifdef MINISQL_HAVE_IO_URING
+
+static int IOUringSetup(unsigned entries, io_uring_params *params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+static int IOUringEnter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+PageIORing::PageIORing(unsigned entries) {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  int ring_fd = IOUringSetup(entries, &params);
+  if (ring_fd < 0) {
+    LOG(WARNING) << "io_uring is not available (" << strerror(errno) << "), using synchronous page I/O";
+    return;
+  }
+  // IORING_OP_READ and IORING_OP_WRITE came with the same kernels as fast poll
+  if (!(params.features & IORING_FEAT_FAST_POLL)) {
+    LOG(WARNING) << "io_uring is too old, using synchronous page I/O";
+    close(ring_fd);
+    return;
+  }
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  if (params.features & IORING_FEAT_SINGLE_MMAP) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+  sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+                  IORING_OFF_SQ_RING);
+  if (params.features & IORING_FEAT_SINGLE_MMAP) {
+    cq_ring_ = sq_ring_;
+  } else {
+    cq_ring_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+                    IORING_OFF_CQ_RING);
+  }
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  sqes_ = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+  if (sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+    LOG(WARNING) << "failed to map the io_uring queues, using synchronous page I/O";
+    if (sqes_ != MAP_FAILED) munmap(sqes_, sqes_size_);
+    if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) munmap(cq_ring_, cq_ring_size_);
+    if (sq_ring_ != MAP_FAILED) munmap(sq_ring_, sq_ring_size_);
+    close(ring_fd);
+    return;
+  }
+  auto sq = static_cast<char *>(sq_ring_);
+  sq_head_ = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+  sq_mask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+  auto cq = static_cast<char *>(cq_ring_);
+  cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+  cq_mask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+  cqes_ = cq + params.cq_off.cqes;
+  sq_entries_ = params.sq_entries;
+  cq_entries_ = params.cq_entries;
+  ring_fd_ = ring_fd;
+  reaper_ = std::thread(&PageIORing::ReapCompletions, this);
+}
+
+/**
+ * Completions may arrive in any order, so the reaper is only told to stop (by a no-op with a null user_data) once
+ * every operation has completed.
+ */
+PageIORing::~PageIORing() {
+  if (!IsAvailable()) {
+    return;
+  }
+  {
+    std::unique_lock<std::mutex> lock(submit_latch_);
+    slot_cv_.wait(lock, [this] { return in_flight_ == 0; });
+    PushSubmission(IORING_OP_NOP, nullptr);
+    Enter();
+  }
+  reaper_.join();
+  munmap(sqes_, sqes_size_);
+  if (cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  munmap(sq_ring_, sq_ring_size_);
+  close(ring_fd_);
+}
+
+void PageIORing::Submit(std::vector<Operation> &operations) {
+  std::unique_lock<std::mutex> lock(submit_latch_);
+  for (auto &operation : operations) {
+    if (in_flight_ + pending_ >= cq_entries_) {
+      // the completion queue must never overflow, wait for the reaper
+      Enter();
+      slot_cv_.wait(lock, [this] { return in_flight_ < cq_entries_; });
+    }
+    PushSubmission(operation.write_ ? IORING_OP_WRITE : IORING_OP_READ, new Operation(std::move(operation)));
+    if (pending_ == sq_entries_) {
+      Enter();
+    }
+  }
+  Enter();
+}
+
+void PageIORing::PushSubmission(uint8_t opcode, Operation *operation) {
+  unsigned tail = *sq_tail_;
+  unsigned index = tail & *sq_mask_;
+  auto sqe = static_cast<io_uring_sqe *>(sqes_) + index;
+  memset(sqe, 0, sizeof(io_uring_sqe));
+  sqe->opcode = opcode;
+  sqe->fd = operation == nullptr ? -1 : operation->fd_;
+  if (operation != nullptr) {
+    sqe->addr = reinterpret_cast<uint64_t>(operation->data_);
+    sqe->len = PAGE_SIZE;
+    sqe->off = operation->offset_;
+  }
+  sqe->user_data = reinterpret_cast<uint64_t>(operation);
+  sq_array_[index] = index;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  pending_++;
+}
+
+/**
+ * The kernel only reads the submission queue during io_uring_enter, so on a hard error the submissions it has not
+ * consumed are taken back out of the queue and failed, instead of leaving their waiters blocked forever.
+ */
+void PageIORing::Enter() {
+  while (pending_ > 0) {
+    int submitted = IOUringEnter(ring_fd_, pending_, 0, 0);
+    if (submitted < 0) {
+      int error = errno;
+      if (error == EINTR || error == EAGAIN || error == EBUSY) {
+        continue;
+      }
+      LOG(ERROR) << "io_uring_enter failed: " << strerror(error);
+      FailPending(error);
+      return;
+    }
+    pending_ -= submitted;
+    in_flight_ += submitted;
+  }
+}
+
+void PageIORing::FailPending(int error) {
+  unsigned tail = *sq_tail_ - pending_;
+  for (unsigned i = tail; i != *sq_tail_; i++) {
+    auto sqe = static_cast<io_uring_sqe *>(sqes_) + sq_array_[i & *sq_mask_];
+    auto operation = reinterpret_cast<Operation *>(sqe->user_data);
+    if (operation != nullptr) {
+      operation->done_(-error);
+      delete operation;
+    }
+  }
+  __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+  pending_ = 0;
+}
+
+void PageIORing::ReapCompletions() {
+  bool stop = false;
+  while (!stop) {
+    if (IOUringEnter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+      LOG(ERROR) << "io_uring_enter failed: " << strerror(errno);
+    }
+    unsigned head = *cq_head_;
+    unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    unsigned reaped = tail - head;
+    for (; head != tail; head++) {
+      auto cqe = static_cast<io_uring_cqe *>(cqes_) + (head & *cq_mask_);
+      auto operation = reinterpret_cast<Operation *>(cqe->user_data);
+      if (operation == nullptr) {
+        stop = true;
+        continue;
+      }
+      operation->done_(cqe->res);
+      delete operation;
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    if (reaped > 0) {
+      std::lock_guard<std::mutex> guard(submit_latch_);
+      in_flight_ -= reaped;
+      slot_cv_.notify_all();
+    }
+  }
+}
+
+#else
+
+PageIORing::PageIORing(unsigned entries) {}
+
+PageIORing::~PageIORing() = default;
+
+void PageIORing::Submit(std::vector<Operation> &operations) {}
+
+void PageIORing::PushSubmission(uint8_t opcode, Operation *operation) {}
+
+void PageIORing::Enter() {}
+
+void PageIORing::FailPending(int error) {}
+
+void PageIORing::ReapCompletions() {}
+
+#endif
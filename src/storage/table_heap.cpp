@@ -3,9 +3,11 @@
 /**
  * TODO: Student Implement
  */
-bool TableHeap::InsertTuple(Row &row, Txn *txn) { 
-  // Step1: Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
+bool TableHeap::InsertTuple(Row &row, Txn *txn, BufferAccessStrategy *strategy) {
+  // Step1: Start from the last page known to take inserts, earlier pages were full when the hint moved past them.
+  page_id_t start_page_id = last_page_id_.load();
+  if (start_page_id == INVALID_PAGE_ID) start_page_id = first_page_id_;
+  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(start_page_id, strategy));
   //LOG(INFO) << page<<" "<<page->GetTablePageId() << " " << page->GetNextPageId();
   // If the page could not be found, then abort the recovery.
   if (page == nullptr) return false;
@@ -14,6 +16,7 @@ bool TableHeap::InsertTuple(Row &row, Txn *txn) {
   while(page != nullptr){
     page->WLatch();
     if (page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_)) {
+      last_page_id_ = page->GetTablePageId();
       page->WUnlatch();
       buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
       return true;
@@ -22,12 +25,16 @@ bool TableHeap::InsertTuple(Row &row, Txn *txn) {
     if (next_page_id != INVALID_PAGE_ID){
       page->WUnlatch();
       buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
-      page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
+      page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id, strategy));
       continue;
     }
     // If the page is full, then create a new page and link it to the current page.
-    auto new_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(next_page_id));
-    if (new_page == nullptr) return false;
+    auto new_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(next_page_id, strategy));
+    if (new_page == nullptr) {
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
+      return false;
+    }
     new_page->Init(next_page_id, page->GetTablePageId(), log_manager_, txn);
     page->SetNextPageId(new_page->GetTablePageId());
     page->WUnlatch();
@@ -127,12 +134,22 @@ void TableHeap::DeleteTable(page_id_t page_id) {
 /**
  * TODO: Student Implement
  */
-TableIterator TableHeap::Begin(Txn *txn) { 
-  TablePage *page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
-  RowId rid;
-  page->GetFirstTupleRid(&rid);
-  return TableIterator(this, rid, txn, true, false);
- }
+TableIterator TableHeap::Begin(Txn *txn, BufferAccessStrategy *strategy) {
+  // leading pages may be empty, an empty heap begins at End()
+  page_id_t page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    TablePage *page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id, strategy));
+    RowId rid;
+    bool found = page->GetFirstTupleRid(&rid);
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    if (found) {
+      return TableIterator(this, rid, txn, true, false, strategy);
+    }
+    page_id = next_page_id;
+  }
+  return End();
+}
 
 /**
  * TODO: Student Implement
@@ -1,5 +1,7 @@
 #include "storage/table_iterator.h"
 
+#include <algorithm>
+
 #include "common/macros.h"
 #include "storage/table_heap.h"
 
@@ -7,7 +9,8 @@
  * TODO: Student Implement
  */
 TableIterator::TableIterator(TableHeap *table_heap, RowId rid, Txn *txn, bool is_begin,
-                        bool is_end) :table_heap_(table_heap), rid_(rid), txn_(txn){ is_begin_=is_begin; is_end_=is_end;}
+                        bool is_end, BufferAccessStrategy *strategy)
+    : table_heap_(table_heap), rid_(rid), txn_(txn), strategy_(strategy) { is_begin_=is_begin; is_end_=is_end;}
 
 // TableIterator::TableIterator(const TableHeap *table_heap, const RowId &rid, const Txn *txn, bool is_begin = false,
 //                 bool is_end = false);
@@ -18,10 +21,13 @@ TableIterator::TableIterator(const TableIterator &other) {
   txn_ = other.txn_;
   is_begin_ = other.is_begin_;
   is_end_ = other.is_end_;
+  strategy_ = other.strategy_;
+  read_ahead_window_ = other.read_ahead_window_;
+  pages_until_read_ahead_ = other.pages_until_read_ahead_;
 }
 
 TableIterator::~TableIterator() {
-
+  delete row_;
 }
 
 bool TableIterator::operator==(const TableIterator &itr) const {
@@ -41,19 +47,30 @@ bool TableIterator::operator!=(const TableIterator &itr) const {
 }
 
 const Row &TableIterator::operator*() {
-  page_id_t page_id = rid_.GetPageId();
-  TablePage* page = reinterpret_cast<TablePage*>(table_heap_->buffer_pool_manager_->FetchPage(page_id));
-  Row* row=new Row(rid_);
-  page->GetTuple(row,table_heap_->schema_,nullptr,nullptr);
-  return *row;
+  LoadRow();
+  return *row_;
 }
 
 Row *TableIterator::operator->() {
-  page_id_t page_id = rid_.GetPageId();
-  TablePage* page = reinterpret_cast<TablePage*>(table_heap_->buffer_pool_manager_->FetchPage(page_id));
-  Row* row=new Row(rid_);
-  page->GetTuple(row,table_heap_->schema_,nullptr,nullptr);
-  return row;
+  LoadRow();
+  return row_;
+}
+
+/**
+ * The row is kept by the iterator, so the page is unpinned right away instead of staying pinned for every row read.
+ */
+void TableIterator::LoadRow() {
+  if (row_ == nullptr) {
+    row_ = new Row(rid_);
+  } else {
+    *row_ = Row(rid_);
+  }
+  auto page = reinterpret_cast<TablePage *>(table_heap_->buffer_pool_manager_->FetchPage(rid_.GetPageId(), strategy_));
+  if (page == nullptr) {
+    return;
+  }
+  page->GetTuple(row_, table_heap_->schema_, nullptr, nullptr);
+  table_heap_->buffer_pool_manager_->UnpinPage(rid_.GetPageId(), false);
 }
 
 TableIterator &TableIterator::operator=(const TableIterator &itr) noexcept {
@@ -61,12 +78,15 @@ TableIterator &TableIterator::operator=(const TableIterator &itr) noexcept {
   rid_ = itr.rid_;
   is_end_ = itr.is_end_;
   is_begin_ = itr.is_begin_;
+  strategy_ = itr.strategy_;
+  read_ahead_window_ = itr.read_ahead_window_;
+  pages_until_read_ahead_ = itr.pages_until_read_ahead_;
   return *this;
 }
 
 // ++iter
 TableIterator &TableIterator::operator++() {
-  auto page = reinterpret_cast<TablePage *>(table_heap_->buffer_pool_manager_->FetchPage(rid_.GetPageId()));
+  auto page = reinterpret_cast<TablePage *>(table_heap_->buffer_pool_manager_->FetchPage(rid_.GetPageId(), strategy_));
   if (page == nullptr) {
     return *this;
   }
@@ -78,25 +98,81 @@ TableIterator &TableIterator::operator++() {
     flag = true;
   } else {
     while (page->GetNextPageId() != INVALID_PAGE_ID) {
+      page_id_t next_page_id = page->GetNextPageId();
       page->WUnlatch();
-      page = reinterpret_cast<TablePage *>(table_heap_->buffer_pool_manager_->FetchPage(page->GetNextPageId()));
+      table_heap_->buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
+      page = reinterpret_cast<TablePage *>(table_heap_->buffer_pool_manager_->FetchPage(next_page_id, strategy_));
       if (page == nullptr) {
         return *this;
       }
       page->WLatch();
+      ReadAhead(page);
       if (page->GetFirstTupleRid(&next_rid)) {flag=true;break;}
-      else {page->WUnlatch();}
     }
   }
   page->WUnlatch();
+  table_heap_->buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
   if(flag) {rid_ = next_rid;is_begin_=false;}
   else{
     rid_.Set(INVALID_PAGE_ID, 0);
+    is_begin_ = false;
     is_end_ = true;
   }
   return *this;
 }
 
+size_t TableIterator::ReadRows(std::vector<Row> &rows, size_t begin) {
+  if (is_end_ || begin >= rows.size()) {
+    return 0;
+  }
+  auto page = reinterpret_cast<TablePage *>(table_heap_->buffer_pool_manager_->FetchPage(rid_.GetPageId(), strategy_));
+  if (page == nullptr) {
+    return 0;
+  }
+  page->RLatch();
+  size_t end = begin;
+  bool has_next = true;
+  RowId next_rid;
+  while (end < rows.size() && has_next) {
+    rows[end].destroy();
+    rows[end].SetRowId(rid_);
+    if (page->GetTuple(&rows[end], table_heap_->schema_, txn_, nullptr)) {
+      end++;
+    }
+    has_next = page->GetNextTupleRid(rid_, &next_rid);
+    if (has_next) {
+      rid_ = next_rid;
+    }
+  }
+  page->RUnlatch();
+  table_heap_->buffer_pool_manager_->UnpinPage(rid_.GetPageId(), false);
+  is_begin_ = false;
+  if (!has_next) {
+    // rid_ is still the last row of the page, moving past it goes on to the next page
+    ++(*this);
+  }
+  return end - begin;
+}
+
+/**
+ * The window starts at TABLE_READ_AHEAD_MIN pages and doubles each time the scan gets through half of it, up to
+ * TABLE_READ_AHEAD_MAX. A scan that keeps consuming pages quickly therefore reads further and further ahead, while a
+ * scan stopped early (e.g. by a LIMIT) only wastes a few reads.
+ */
+void TableIterator::ReadAhead(TablePage *page) {
+  if (pages_until_read_ahead_ > 0) {
+    pages_until_read_ahead_--;
+    return;
+  }
+  if (page->GetNextPageId() == INVALID_PAGE_ID) {
+    return;
+  }
+  read_ahead_window_ = read_ahead_window_ == 0 ? TABLE_READ_AHEAD_MIN
+                                               : std::min<size_t>(read_ahead_window_ * 2, TABLE_READ_AHEAD_MAX);
+  table_heap_->buffer_pool_manager_->PrefetchPage(page->GetNextPageId(), read_ahead_window_, TablePage::NextPageIdOf);
+  pages_until_read_ahead_ = read_ahead_window_ / 2;
+}
+
 // iter++
 TableIterator TableIterator::operator++(int) { 
   TableIterator ret_val(*this);